@@ -0,0 +1,433 @@
+/*
+ * uranus_bench.cpp
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ *
+ * 运动核心基准测试，结果以JSON或CSV输出，用于版本间的性能回归对比
+ * 用法: uranus_bench [--format json|csv] [--output file] [--filter name]
+ *                    [--repetitions n] [--min-time ms] [--max-axes n]
+ *
+ */
+
+#include "Axis.h"
+#include "ExeclQueue.h"
+#include "FbSingleAxis.h"
+#include "PlanCache.h"
+#include "ProfileBatch.h"
+#include "ProfilePlanner.h"
+#include "Scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Uranus;
+
+namespace
+{
+
+struct Options
+{
+    bool mCsv = false;
+    const char *mOutput = nullptr;
+    const char *mFilter = nullptr;
+    uint32_t mRepetitions = 5;
+    double mMinTime = 0.05; // 每次重复的最短时间(s)
+    uint32_t mMaxAxes = 1024;
+};
+
+struct Result
+{
+    std::string mName;
+    uint32_t mAxes = 0;
+    uint64_t mIterations = 0; // 每次重复的操作数
+    double mMean = 0;         // ns/op
+    double mMedian = 0;
+    double mMin = 0;
+    double mMax = 0;
+};
+
+Options gOptions;
+std::vector<Result> gResults;
+
+double now(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename Body>
+void measure(const char *name, uint32_t axes, Body &&body)
+{
+    std::string fullName = name;
+    if (gOptions.mFilter && fullName.find(gOptions.mFilter) == std::string::npos)
+        return;
+
+    // 标定每次重复的操作数，使耗时不短于mMinTime
+    uint64_t iterations = 1;
+    while (true)
+    {
+        double start = now();
+        body(iterations);
+        double elapsed = now() - start;
+        if (elapsed >= gOptions.mMinTime || iterations >= (1ULL << 40))
+            break;
+
+        double scale = elapsed > 0 ? gOptions.mMinTime / elapsed * 1.2 : 100.0;
+        iterations = (uint64_t)(iterations * std::min(std::max(scale, 2.0), 100.0));
+    }
+
+    std::vector<double> samples;
+    for (uint32_t i = 0; i < gOptions.mRepetitions; ++i)
+    {
+        double start = now();
+        body(iterations);
+        samples.push_back((now() - start) * 1e9 / iterations);
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    Result result;
+    result.mName = fullName;
+    result.mAxes = axes;
+    result.mIterations = iterations;
+    result.mMin = samples.front();
+    result.mMax = samples.back();
+    result.mMedian = samples[samples.size() / 2];
+    for (double sample : samples)
+        result.mMean += sample / samples.size();
+
+    fprintf(stderr, "%-32s axes %5u  %12.1f ns/op\n", result.mName.c_str(), axes, result.mMedian);
+    gResults.push_back(result);
+}
+
+////////////////////////////////////////////////////////////
+
+void benchPlan(void)
+{
+    ProfilePlanner planner;
+    PlanCache cache;
+    cache.setSize(8);
+    volatile bool ret;
+
+    measure("planner.plan.trapezoid", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i)
+            ret = planner.plan(0, 100, 0, 100, 0, 1000, 800);
+    });
+
+    measure("planner.plan.scurve", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i)
+            ret = planner.plan(0, 100, 0, 100, 0, 1000, 800, 0, 20000);
+    });
+
+    measure("planner.plan.scurve_cached", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i)
+            ret = planner.plan(0, 100, 0, 100, 0, 1000, 800, 0, 20000, &cache);
+    });
+
+    (void)ret;
+}
+
+void benchExecute(void)
+{
+    // 长距离运动，测试期间几乎不需要重新规划
+    ProfilePlanner planner;
+    volatile double sink;
+
+    planner.plan(0, 1e6, 0, 100, 0, 1000, 800);
+    measure("planner.execute.trapezoid", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i)
+        {
+            if (planner.execute())
+                planner.plan(0, 1e6, 0, 100, 0, 1000, 800);
+            sink = planner.getPosition();
+        }
+    });
+
+    planner.plan(0, 1e6, 0, 100, 0, 1000, 800, 0, 20000);
+    measure("planner.execute.scurve", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i)
+        {
+            if (planner.execute())
+                planner.plan(0, 1e6, 0, 100, 0, 1000, 800, 0, 20000);
+            sink = planner.getPosition();
+        }
+    });
+
+    (void)sink;
+}
+
+////////////////////////////////////////////////////////////
+
+// 只测试队列本身的开销，节点在第一次执行时完成
+class BenchNode : public ExeclNode
+{
+protected:
+    MC_ErrorCode onActive(ExeclQueue *queue) override { return MC_ErrorCode::GOOD; }
+    MC_ErrorCode onExecuting(ExeclQueue *queue, ExeclNodeExecStat &stat) override
+    {
+        stat = ExeclNodeExecStat::DONE;
+        return MC_ErrorCode::GOOD;
+    }
+    void onAborted(ExeclQueue *queue) override {}
+    void onDone(ExeclQueue *queue, bool &isHold) override {}
+    void onError(ExeclQueue *queue, MC_ErrorCode errorCode) override {}
+};
+
+class BenchQueue : public ExeclQueue
+{
+public:
+    BenchQueue() { reserveNode(sizeof(BenchNode)); }
+};
+
+void benchQueue(void)
+{
+    BenchQueue queue;
+
+    measure("queue.push_process", 1, [&](uint64_t n) {
+        BenchNode *node;
+        for (uint64_t i = 0; i < n; ++i)
+        {
+            queue.emplace(node, false);
+            queue.processExeclNode();
+        }
+    });
+
+    measure("queue.push_abort", 1, [&](uint64_t n) {
+        BenchNode *node;
+        for (uint64_t i = 0; i < n; ++i)
+            queue.emplace(node, (i % queue.queueDepth()) == 0);
+        queue.setAllNodesAborted();
+    });
+}
+
+////////////////////////////////////////////////////////////
+
+struct AxisRig
+{
+    Scheduler mSched;
+    std::vector<Axis *> mAxes;
+    std::vector<FbPower> mPowers;
+    std::vector<double> mTargets;
+
+    explicit AxisRig(uint32_t num)
+    {
+        mSched.setFrequency(1000);
+        mPowers.resize(num);
+        for (uint32_t i = 0; i < num; ++i)
+        {
+            Axis *axis = mSched.newAxis((int32_t)i, new Servo());
+            mAxes.push_back(axis);
+            mPowers[i].mAxis = axis;
+            mPowers[i].mEnable = mPowers[i].mEnablePositive = mPowers[i].mEnableNegative = true;
+        }
+        mTargets.assign(num, 0);
+
+        for (int i = 0; i < 10; ++i)
+        {
+            mSched.runCycle();
+            for (FbPower &power : mPowers)
+                power.call();
+        }
+
+        for (FbPower &power : mPowers)
+        {
+            if (!power.mStatus)
+                fprintf(stderr, "axis power on failed, results are not meaningful\n");
+        }
+    }
+
+    ~AxisRig()
+    {
+        mSched.release();
+    }
+
+    // 空闲的轴在两点间往返，各轴行程不同使段切换分散到各周期
+    void feed(void)
+    {
+        for (size_t i = 0; i < mAxes.size(); ++i)
+        {
+            if (mAxes[i]->busy())
+                continue;
+
+            mTargets[i] = mTargets[i] ? 0 : 1 + (double)(i % 17) / 4;
+            mAxes[i]->addMovePos(nullptr, mTargets[i], 50, 500, 500, 0);
+        }
+    }
+};
+
+void benchAxis(void)
+{
+    AxisRig rig(1);
+    Axis *axis = rig.mAxes[0];
+
+    measure("axis.runCycle", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i)
+        {
+            rig.feed();
+            axis->runCycle();
+        }
+    });
+
+    measure("axis.push", 1, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i)
+        {
+            // 缓冲满一个队列后以打断方式清空
+            bool abort = (i % axis->queueDepth()) == 0;
+            axis->addMovePos(nullptr, (double)(i % 8), 100, 1000, 1000, 0, MC_ShiftingMode::ABSOLUTE,
+                             MC_Direction::CURRENT, abort ? MC_BufferMode::ABORTING : MC_BufferMode::BUFFERED);
+        }
+    });
+}
+
+void benchScheduler(void)
+{
+    for (uint32_t num = 1; num <= gOptions.mMaxAxes; num *= 2)
+    {
+        AxisRig rig(num);
+        measure("scheduler.runCycle", num, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                rig.feed();
+                rig.mSched.runCycle();
+            }
+        });
+
+        rig.mSched.setBatchStepping(true);
+        measure("scheduler.runCycle_batch", num, [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                rig.feed();
+                rig.mSched.runCycle();
+            }
+        });
+    }
+}
+
+////////////////////////////////////////////////////////////
+
+void writeJson(FILE *file)
+{
+    fprintf(file, "{\n  \"benchmark\": \"uranus_bench\",\n");
+#if defined(__VERSION__)
+    fprintf(file, "  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+#if defined(NDEBUG)
+    fprintf(file, "  \"optimized\": true,\n");
+#else
+    fprintf(file, "  \"optimized\": false,\n");
+#endif
+    fprintf(file, "  \"simd\": %s,\n", ProfileBatch::simdEnabled() ? "true" : "false");
+    fprintf(file, "  \"repetitions\": %u,\n  \"results\": [\n", gOptions.mRepetitions);
+
+    for (size_t i = 0; i < gResults.size(); ++i)
+    {
+        const Result &r = gResults[i];
+        fprintf(file,
+                "    {\"name\": \"%s\", \"axes\": %u, \"iterations\": %llu, \"ns_per_op\": %.3f, "
+                "\"median_ns\": %.3f, \"min_ns\": %.3f, \"max_ns\": %.3f, \"ns_per_axis\": %.3f}%s\n",
+                r.mName.c_str(), r.mAxes, (unsigned long long)r.mIterations, r.mMean, r.mMedian, r.mMin, r.mMax,
+                r.mMean / r.mAxes, (i + 1 < gResults.size()) ? "," : "");
+    }
+
+    fprintf(file, "  ]\n}\n");
+}
+
+void writeCsv(FILE *file)
+{
+    fprintf(file, "name,axes,iterations,ns_per_op,median_ns,min_ns,max_ns,ns_per_axis\n");
+    for (const Result &r : gResults)
+    {
+        fprintf(file, "%s,%u,%llu,%.3f,%.3f,%.3f,%.3f,%.3f\n", r.mName.c_str(), r.mAxes,
+                (unsigned long long)r.mIterations, r.mMean, r.mMedian, r.mMin, r.mMax, r.mMean / r.mAxes);
+    }
+}
+
+bool parseOptions(int argc, char **argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (!strcmp(arg, "--format") && value)
+        {
+            if (strcmp(value, "json") && strcmp(value, "csv"))
+                return false;
+            gOptions.mCsv = !strcmp(value, "csv");
+        }
+        else if (!strcmp(arg, "--output") && value)
+            gOptions.mOutput = value;
+        else if (!strcmp(arg, "--filter") && value)
+            gOptions.mFilter = value;
+        else if (!strcmp(arg, "--repetitions") && value && atoi(value) > 0)
+            gOptions.mRepetitions = (uint32_t)atoi(value);
+        else if (!strcmp(arg, "--min-time") && value && atof(value) > 0)
+            gOptions.mMinTime = atof(value) / 1000;
+        else if (!strcmp(arg, "--max-axes") && value && atoi(value) > 0)
+            gOptions.mMaxAxes = (uint32_t)atoi(value);
+        else
+            return false;
+
+        ++i;
+    }
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (!parseOptions(argc, argv))
+    {
+        fprintf(stderr, "usage: %s [--format json|csv] [--output file] [--filter name]\n"
+                        "       [--repetitions n] [--min-time ms] [--max-axes n]\n",
+                argv[0]);
+        return 2;
+    }
+
+    benchPlan();
+    benchExecute();
+    benchQueue();
+    benchAxis();
+    benchScheduler();
+
+    FILE *file = gOptions.mOutput ? fopen(gOptions.mOutput, "w") : stdout;
+    if (!file)
+    {
+        fprintf(stderr, "cannot open %s\n", gOptions.mOutput);
+        return 1;
+    }
+
+    if (gOptions.mCsv)
+        writeCsv(file);
+    else
+        writeJson(file);
+
+    if (file != stdout)
+        fclose(file);
+
+    return 0;
+}
@@ -28,11 +28,10 @@
 
 #include "FbSingleAxis.h"
 #include "Scheduler.h"
+#include "CycleRunner.h"
 #include <iomanip>
 #include <iostream>
 #include <stdio.h>
-#include <thread>
-#include <chrono>
 
 using namespace Uranus;
 using namespace std;
@@ -95,11 +94,8 @@ int main(void)
 
     double t = 0;
     // “实时”周期任务
-    while (1)
+    auto cycle = [&]() -> bool
     {
-        // 调度器周期处理
-        sched.runCycle();
-
         // 功能块调用
         power.call();
         home.call();
@@ -119,12 +115,17 @@ int main(void)
         if (home.mDone)
         { // 提示回零完成并退出
             cout << "homing complete" << endl;
-            break;
+            return false;
         }
 
-        this_thread::sleep_for(std::chrono::microseconds((long)(1000000 / frequency)));
         t += 1 / frequency;
-    }
+        return true;
+    };
+
+    // 按绝对截止时间周期驱动调度器，回调返回false时结束
+    CycleRunner runner(&sched);
+    runner.addCallback(cycle);
+    runner.run();
 
     return 0;
 }
@@ -27,10 +27,9 @@
 
 #include "FbSingleAxis.h"
 #include "Scheduler.h"
+#include "CycleRunner.h"
 #include <iomanip>
 #include <iostream>
-#include <chrono>
-#include <thread>
 
 using namespace Uranus;
 using namespace std;
@@ -80,11 +79,8 @@ int main(void)
     double t = 0;
     bool moveAbs1AlreadyDone = false;
     // “实时”周期任务
-    while (1)
+    auto cycle = [&]() -> bool
     {
-        // 调度器周期处理
-        sched.runCycle();
-
         // 功能块调用
         power.call();
         moveAbs1.call();
@@ -114,12 +110,17 @@ int main(void)
         if (moveAbs2.mDone)
         { // 提示move2完成并退出
             cout << "moveAbs2 complete" << endl;
-            break;
+            return false;
         }
 
-        this_thread::sleep_for(std::chrono::microseconds((long)(1000000 / frequency)));
         t += 1 / frequency;
-    }
+        return true;
+    };
+
+    // 按绝对截止时间周期驱动调度器，回调返回false时结束
+    CycleRunner runner(&sched);
+    runner.addCallback(cycle);
+    runner.run();
 
     return 0;
 }
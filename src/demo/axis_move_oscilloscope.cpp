@@ -23,10 +23,9 @@
 
 #include "FbSingleAxis.h"
 #include "Scheduler.h"
+#include "CycleRunner.h"
 #include <iomanip>
 #include <iostream>
-#include <chrono>
-#include <thread>
 #include <vector>
 #include <queue>
 #include <map>
@@ -119,11 +118,8 @@ int main(void)
     // “实时”周期任务
     Oscilloscope oscope;
 
-    while (1)
+    auto cycle = [&]() -> bool
     {
-        // 调度器周期处理
-        sched.runCycle();
-
         // 功能块调用
         power.call();
         moveAbs1.call();
@@ -146,10 +142,9 @@ int main(void)
 
         if (moveAbs2.mDone)
         { 
-            break;
+            return false;
         }
 
-        this_thread::sleep_for(std::chrono::microseconds((long)(1000000 / frequency)));
         t += 1 / frequency;
 
         oscope.Add("M1:Done", moveAbs1.mDone);
@@ -162,7 +157,13 @@ int main(void)
         oscope.Add("M2:Error", moveAbs2.mError);
 
         oscope.Print();
-    }
+        return true;
+    };
+
+    // 按绝对截止时间周期驱动调度器，回调返回false时结束
+    CycleRunner runner(&sched);
+    runner.addCallback(cycle);
+    runner.run();
 
     return 0;
 }
@@ -0,0 +1,154 @@
+﻿/*
+ * axis_shm.cpp
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ *
+ * 示例代码，通过共享内存过程映像与独立进程中的总线主站交换数据
+ * 无参数运行时在本进程的线程中启动替身主站；
+ * 也可在两个终端分别运行 axis_shm core 与 axis_shm master
+ *
+ */
+
+#include "FbSingleAxis.h"
+#include "Scheduler.h"
+#include "ShmServoBus.h"
+#include "CycleRunner.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+using namespace Uranus;
+using namespace std;
+
+static const char *kImageName = "uranus_axis_shm";
+static const double kFrequency = 100;
+
+// 替身主站：按总线周期执行，直到运动核心关闭映像
+static int runMaster(atomic<bool> *exit)
+{
+    ShmServoMaster master;
+    while (MC_ErrorCode::GOOD != master.open(kImageName))
+    { // 等待运动核心创建映像
+        if (exit && *exit)
+            return 0;
+        this_thread::sleep_for(chrono::milliseconds(100));
+    }
+
+    cout << "master attached, " << master.slaveNum() << " slaves" << endl;
+
+    auto period = chrono::microseconds((int64_t)(1e6 / kFrequency));
+    auto next = chrono::steady_clock::now();
+    while (master.runCycle(kFrequency) && !(exit && *exit))
+    {
+        next += period;
+        this_thread::sleep_until(next);
+    }
+
+    cout << "master detached" << endl;
+    return 0;
+}
+
+static int runCore(void)
+{
+    cout.precision(8);
+
+    ShmServoBus bus(2);
+    if (MC_ErrorCode::GOOD != bus.open(kImageName))
+    {
+        cout << "open shared memory failed" << endl;
+        return 1;
+    }
+
+    Scheduler sched;
+    sched.setFrequency(kFrequency);
+    sched.setServoBus(&bus);
+    Axis *axis = sched.newAxis(1, bus.newServo(0));
+
+    FbPower power;
+    power.mAxis = axis;
+    power.mEnable = true;
+    power.mEnablePositive = true;
+    power.mEnableNegative = true;
+
+    FbMoveAbsolute moveAbs;
+    moveAbs.mAxis = axis;
+    moveAbs.mPosition = 500;
+    moveAbs.mVelocity = 400;
+    moveAbs.mAcceleration = 500;
+    moveAbs.mDeceleration = 500;
+
+    FbReadActualPosition readPos;
+    readPos.mAxis = axis;
+    readPos.mEnable = true;
+
+    uint32_t cycles = 0;
+    auto cycle = [&]() -> bool
+    {
+        power.call();
+        moveAbs.mExecute = power.mStatus && power.mValid;
+        moveAbs.call();
+        readPos.call();
+
+        // 主站每周期发布一次输入，序号表示本周期使用的数据
+        if (++cycles % 10 == 0)
+            cout << "cycle:" << cycles << ",\tinput seq:" << bus.inputSequence()
+                 << ",\tposition:" << fixed << readPos.mPosition << endl;
+
+        if (bus.staleCycles() > kFrequency)
+        {
+            cout << "no input from master" << endl;
+            return false;
+        }
+
+        if (moveAbs.mDone)
+        {
+            cout << "moveAbs complete" << endl;
+            return false;
+        }
+
+        return true;
+    };
+
+    CycleRunner runner(&sched);
+    runner.addCallback(cycle);
+    runner.run();
+
+    sched.release();
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && !strcmp(argv[1], "master"))
+        return runMaster(nullptr);
+
+    if (argc > 1 && !strcmp(argv[1], "core"))
+        return runCore();
+
+    atomic<bool> exit{false};
+    thread master(runMaster, &exit);
+    int ret = runCore();
+    exit = true;
+    master.join();
+    return ret;
+}
@@ -0,0 +1,168 @@
+/*
+ * axis_sim.cpp
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ * 示例代码，以虚拟时钟快速仿真多台设备的整班运行：
+ * 每台设备为独立的调度器实例，轴由SimServo驱动并往复运动，
+ * SimRunner背靠背执行各设备的周期并在多核上并行，结束后输出仿真速度
+ * 用法：axis_sim [仿真小时数] [设备数] [线程数]
+ *
+ */
+
+#include "FbSingleAxis.h"
+#include "Scheduler.h"
+#include "SimServo.h"
+#include "SimRunner.h"
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace Uranus;
+using namespace std;
+
+static const double kFrequency = 1000;
+static const int32_t kAxisNum = 4;
+
+// 单轴程序：使能后在两个位置间往复
+struct AxisProgram
+{
+    FbPower mPower;
+    FbMoveAbsolute mMove[2];
+    int32_t mPhase = 0;
+    uint64_t mStrokes = 0;
+
+    void init(Axis *axis, double stroke)
+    {
+        mPower.mAxis = axis;
+        mPower.mEnable = true;
+        mPower.mEnablePositive = true;
+        mPower.mEnableNegative = true;
+
+        for (int32_t i = 0; i < 2; ++i)
+        {
+            mMove[i].mAxis = axis;
+            mMove[i].mPosition = i ? 0 : stroke;
+            mMove[i].mVelocity = 20;
+            mMove[i].mAcceleration = 200;
+            mMove[i].mDeceleration = 200;
+        }
+    }
+
+    // 返回错误码，GOOD为正常
+    MC_ErrorCode call(void)
+    {
+        mPower.call();
+        mMove[0].call();
+        mMove[1].call();
+
+        FbMoveAbsolute &move = mMove[mPhase];
+        if (move.mError)
+            return move.mErrorID;
+
+        if (mPower.mStatus && mPower.mValid && !move.mExecute)
+            move.mExecute = true;
+
+        if (move.mDone)
+        { // 到位后切换到另一端
+            move.mExecute = false;
+            mPhase ^= 1;
+            ++mStrokes;
+        }
+        return MC_ErrorCode::GOOD;
+    }
+};
+
+// 一台设备：独立的调度器及其轴程序
+struct Machine
+{
+    Scheduler mSched;
+    AxisProgram mPrograms[kAxisNum];
+    MC_ErrorCode mError = MC_ErrorCode::GOOD;
+
+    void init(void)
+    {
+        mSched.setFrequency(kFrequency);
+        for (int32_t i = 0; i < kAxisNum; ++i)
+            mPrograms[i].init(mSched.newAxis(i + 1, new SimServo()), 5 + i);
+    }
+
+    // 周期回调，出错时停止本设备
+    bool operator()(void)
+    {
+        for (auto &program : mPrograms)
+        {
+            MC_ErrorCode err = program.call();
+            if (err != MC_ErrorCode::GOOD)
+            {
+                mError = err;
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    double hours = argc > 1 ? atof(argv[1]) : 0.05;
+    int32_t machineNum = argc > 2 ? atoi(argv[2]) : 4;
+    uint32_t threadNum = argc > 3 ? atoi(argv[3]) : 0;
+    if (hours <= 0 || machineNum <= 0)
+    {
+        cout << "usage: axis_sim [hours] [machines] [threads]" << endl;
+        return 1;
+    }
+
+    vector<Machine> machines(machineNum);
+    SimRunner runner;
+    runner.setThreadNum(threadNum);
+    for (auto &machine : machines)
+    {
+        uint32_t instance;
+        machine.init();
+        runner.addScheduler(&machine.mSched, instance);
+        runner.addCallback(instance, machine);
+    }
+
+    runner.run(hours * 3600);
+
+    for (int32_t i = 0; i < machineNum; ++i)
+    {
+        uint64_t strokes = 0;
+        for (auto &program : machines[i].mPrograms)
+            strokes += program.mStrokes;
+
+        cout << "machine " << i << ": simTime " << fixed << setprecision(1) << runner.simTime(i)
+             << "s, strokes " << strokes;
+        if (machines[i].mError != MC_ErrorCode::GOOD)
+            cout << ", error 0x" << hex << (int32_t)machines[i].mError << dec;
+        cout << endl;
+    }
+
+    SimStatistics stat;
+    runner.readStatistics(stat);
+    cout << "threads " << stat.mThreads << ", cycles " << stat.mCycles << ", wall " << setprecision(3)
+         << stat.mWallTime << "s, " << setprecision(0) << stat.mCyclesPerSecond << " cycles/s, "
+         << setprecision(1) << stat.mRealtimeFactor << "x realtime" << endl;
+
+    return 0;
+}
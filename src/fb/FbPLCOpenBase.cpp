@@ -23,6 +23,7 @@
  */
 
 #include "FbPLCOpenBase.h"
+#include "Axis.h"
 
 namespace Uranus
 {
@@ -206,6 +207,23 @@ namespace Uranus
 
     ////////////////////////////////////////////////////////////
 
+    void FbContinuousUpdateType::call(void)
+    {
+        FbSeqExecuteType::call();
+
+        if (mContinuousUpdate && mBusy && mAxis)
+        {
+            MC_ErrorCode err = onAxisUpdate();
+            if (MC_ErrorCode::GOOD != err)
+            { // 运动已按旧参数执行，输入非法时停轴，使轴与功能块状态一致
+                mAxis->emergStop(err);
+                onOperationError(err, 0);
+            }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+
     void FbExecAxisBufferContType::onOperationDone(int32_t customId)
     {
         mCommandAborted = false;
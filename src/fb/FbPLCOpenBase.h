@@ -190,6 +190,19 @@ namespace Uranus
     {
     };
 
+    class FbContinuousUpdateType : virtual public FbExecAxisBufferType
+    {
+    public:
+        FB_INPUT BOOL mContinuousUpdate = false;
+
+    public:
+        void call(void);
+
+    public:
+        // mContinuousUpdate为真且运动未完成时每次调用，以当前输入更新运动
+        virtual MC_ErrorCode onAxisUpdate(void) = 0;
+    };
+
     class FbExecAxisBufferContType : virtual public FbExecAxisBufferType
     {
     public:
@@ -92,6 +92,12 @@ namespace Uranus
                                  mDirection, mBufferMode);
     }
 
+    MC_ErrorCode FbMoveAbsolute::onAxisUpdate(void)
+    {
+        return mAxis->updateMovePos(this, mPosition, mVelocity, mAcceleration, mDeceleration, mJerk,
+                                    MC_ShiftingMode::ABSOLUTE, mDirection);
+    }
+
     ////////////////////////////////////////////////////////////
 
     MC_ErrorCode FbMoveRelative::onAxisExecPosedge(void)
@@ -100,6 +106,12 @@ namespace Uranus
             MC_Direction::CURRENT, mBufferMode);
     }
 
+    MC_ErrorCode FbMoveRelative::onAxisUpdate(void)
+    {
+        return mAxis->updateMovePos(this, mDistance, mVelocity, mAcceleration, mDeceleration, mJerk,
+                                    MC_ShiftingMode::RELATIVE);
+    }
+
     ////////////////////////////////////////////////////////////
 
     MC_ErrorCode FbMoveAdditive::onAxisExecPosedge(void)
@@ -108,6 +120,12 @@ namespace Uranus
             MC_Direction::CURRENT, mBufferMode);
     }
 
+    MC_ErrorCode FbMoveAdditive::onAxisUpdate(void)
+    {
+        return mAxis->updateMovePos(this, mDistance, mVelocity, mAcceleration, mDeceleration, mJerk,
+                                    MC_ShiftingMode::ADDITIVE);
+    }
+
     ////////////////////////////////////////////////////////////
 
     MC_ErrorCode FbMoveVelocity::onAxisExecPosedge(void)
@@ -115,6 +133,11 @@ namespace Uranus
         return mAxis->addMoveVel(this, mVelocity, mAcceleration, mDeceleration, mJerk, mBufferMode);
     }
 
+    MC_ErrorCode FbMoveVelocity::onAxisUpdate(void)
+    {
+        return mAxis->updateMoveVel(this, mVelocity, mAcceleration, mDeceleration, mJerk);
+    }
+
     ////////////////////////////////////////////////////////////
 
     MC_ErrorCode FbReadStatus::onAxisEnable(bool &isDone)
@@ -256,6 +279,202 @@ namespace Uranus
 
     ////////////////////////////////////////////////////////////
 
+    // MC_Parameter中的标准参数由轴处理，其余参数号转给驱动器
+    static bool isAxisParameter(MC_Parameter number)
+    {
+        return (int)number >= (int)MC_Parameter::COMMANDED_POSITION &&
+               (int)number <= (int)MC_Parameter::MAX_JERK_APPL;
+    }
+
+    static MC_ErrorCode readAxisParameter(Axis *axis, MC_Parameter number, double &value)
+    {
+        switch (number)
+        {
+        case MC_Parameter::COMMANDED_POSITION:
+            value = axis->cmdPosition();
+            break;
+        case MC_Parameter::SWLIMIT_POS:
+            value = axis->rangeLimitInfo().mLimitPositive;
+            break;
+        case MC_Parameter::SWLIMIT_NEG:
+            value = axis->rangeLimitInfo().mLimitNegative;
+            break;
+        case MC_Parameter::ENABLE_LIMIT_POS:
+            value = axis->rangeLimitInfo().mSwLimitPositive;
+            break;
+        case MC_Parameter::ENABLE_LIMIT_NEG:
+            value = axis->rangeLimitInfo().mSwLimitNegative;
+            break;
+        case MC_Parameter::ENABLE_POS_LAG_MONITORING:
+            value = MC_ControlMode::VELOPENLOOP != axis->controlInfo().mControlMode;
+            break;
+        case MC_Parameter::MAX_POSITION_LAG:
+            value = axis->motionLimitInfo().mPosLagLimit;
+            break;
+        case MC_Parameter::MAX_VELOCITY_SYSTEM:
+            value = axis->motionLimitInfo().mVelLimit;
+            break;
+        case MC_Parameter::ACTUAL_VELOCITY:
+            value = axis->actVelocity();
+            break;
+        case MC_Parameter::COMMANDED_VELOCITY:
+            value = axis->cmdVelocity();
+            break;
+        case MC_Parameter::MAX_ACCELERATION_SYSTEM:
+        case MC_Parameter::MAX_DECELERATION_SYSTEM:
+            value = axis->motionLimitInfo().mAccLimit;
+            break;
+        default:
+            return MC_ErrorCode::PARAMETER_NOT_SUPPORT;
+        }
+
+        return MC_ErrorCode::GOOD;
+    }
+
+    static MC_ErrorCode writeAxisParameter(Axis *axis, MC_Parameter number, double value)
+    {
+        AxisRangeLimitInfo range = axis->rangeLimitInfo();
+        AxisMotionLimitInfo motion = axis->motionLimitInfo();
+
+        switch (number)
+        {
+        case MC_Parameter::SWLIMIT_POS:
+            range.mLimitPositive = value;
+            return axis->setRangeLimitInfo(range);
+        case MC_Parameter::SWLIMIT_NEG:
+            range.mLimitNegative = value;
+            return axis->setRangeLimitInfo(range);
+        case MC_Parameter::ENABLE_LIMIT_POS:
+            range.mSwLimitPositive = value != 0;
+            return axis->setRangeLimitInfo(range);
+        case MC_Parameter::ENABLE_LIMIT_NEG:
+            range.mSwLimitNegative = value != 0;
+            return axis->setRangeLimitInfo(range);
+        case MC_Parameter::MAX_POSITION_LAG:
+            motion.mPosLagLimit = value;
+            return axis->setMotionLimitInfo(motion);
+        case MC_Parameter::MAX_VELOCITY_SYSTEM:
+            motion.mVelLimit = value;
+            return axis->setMotionLimitInfo(motion);
+        case MC_Parameter::MAX_ACCELERATION_SYSTEM:
+        case MC_Parameter::MAX_DECELERATION_SYSTEM: // 加减速共用一个限值，与读取一致
+            motion.mAccLimit = value;
+            return axis->setMotionLimitInfo(motion);
+        default:
+            return MC_ErrorCode::PARAMETER_NOT_SUPPORT;
+        }
+    }
+
+    FbReadParameter::~FbReadParameter()
+    {
+        // 放弃未取走的请求，避免占用伺服的请求槽
+        if (mRequest && mAxis)
+            mAxis->servoCancelVal(mRequest);
+    }
+
+    MC_ErrorCode FbReadParameter::onAxisEnable(bool &isDone)
+    {
+        if (isAxisParameter(mParameterNumber))
+        {
+            isDone = true;
+            return readAxisParameter(mAxis, mParameterNumber, mValue);
+        }
+
+        if (mRequest && mRequestNumber != mParameterNumber)
+        { // 参数号改变，放弃旧请求
+            mAxis->servoCancelVal(mRequest);
+            mRequest = 0;
+            mHasValue = false;
+        }
+
+        if (!mRequest)
+        {
+            if (!mAxis->servoReadValAsync((int)mParameterNumber, mRequest))
+                return MC_ErrorCode::QUEUEFULL;
+            mRequestNumber = mParameterNumber;
+        }
+
+        double value;
+        switch (mAxis->servoPollVal(mRequest, value))
+        {
+        case ServoValStat::BUSY:
+            break;
+
+        case ServoValStat::DONE:
+            mValue = value;
+            mHasValue = true;
+            mRequest = 0;
+            break;
+
+        default:
+            mRequest = 0;
+            return MC_ErrorCode::PARAMETER_NOT_SUPPORT;
+        }
+
+        isDone = mHasValue;
+        return MC_ErrorCode::GOOD;
+    }
+
+    void FbReadParameter::onDisable(void)
+    {
+        if (mRequest && mAxis)
+            mAxis->servoCancelVal(mRequest);
+
+        mRequest = 0;
+        mHasValue = false;
+        mValue = 0;
+    }
+
+    ////////////////////////////////////////////////////////////
+
+    FbWriteParameter::~FbWriteParameter()
+    {
+        if (mRequest && mAxis)
+            mAxis->servoCancelVal(mRequest);
+    }
+
+    void FbWriteParameter::call(void)
+    {
+        if (!mExecute && mRequest)
+        { // 写入不能撤回，只放弃结果
+            if (mAxis)
+                mAxis->servoCancelVal(mRequest);
+            mRequest = 0;
+        }
+
+        FbWriteInfoAxisType::call();
+    }
+
+    MC_ErrorCode FbWriteParameter::onAxisTriggered(bool &isDone)
+    {
+        if (isAxisParameter(mParameterNumber))
+        {
+            isDone = true;
+            return writeAxisParameter(mAxis, mParameterNumber, mValue);
+        }
+
+        if (!mRequest)
+        {
+            if (!mAxis->servoWriteValAsync((int)mParameterNumber, mValue, mRequest))
+                return MC_ErrorCode::QUEUEFULL;
+            return MC_ErrorCode::GOOD;
+        }
+
+        double value;
+        ServoValStat stat = mAxis->servoPollVal(mRequest, value);
+        if (ServoValStat::BUSY == stat)
+            return MC_ErrorCode::GOOD;
+
+        mRequest = 0;
+        if (ServoValStat::DONE != stat)
+            return MC_ErrorCode::PARAMETER_NOT_SUPPORT;
+
+        isDone = true;
+        return MC_ErrorCode::GOOD;
+    }
+
+    ////////////////////////////////////////////////////////////
+
     MC_ErrorCode FbReadActualPosition::onAxisEnable(bool &isDone)
     {
         mPosition = mAxis->actPosition();
@@ -81,7 +81,7 @@ namespace Uranus
         MC_ErrorCode onAxisExecPosedge(void);
     };
 
-    class FbMoveAbsolute : public FbExecAxisBufferType
+    class FbMoveAbsolute : public FbContinuousUpdateType
     {
     public:
         FB_INPUT LREAL mPosition = 0;
@@ -93,9 +93,10 @@ namespace Uranus
 
     public:
         MC_ErrorCode onAxisExecPosedge(void);
+        MC_ErrorCode onAxisUpdate(void);
     };
 
-    class FbMoveRelative : public FbExecAxisBufferType
+    class FbMoveRelative : public FbContinuousUpdateType
     {
     public:
         FB_INPUT LREAL mDistance = 0;
@@ -106,9 +107,10 @@ namespace Uranus
 
     public:
         MC_ErrorCode onAxisExecPosedge(void);
+        MC_ErrorCode onAxisUpdate(void);
     };
 
-    class FbMoveAdditive : public FbExecAxisBufferType
+    class FbMoveAdditive : public FbContinuousUpdateType
     {
     public:
         FB_INPUT LREAL mDistance = 0;
@@ -119,9 +121,10 @@ namespace Uranus
 
     public:
         MC_ErrorCode onAxisExecPosedge(void);
+        MC_ErrorCode onAxisUpdate(void);
     };
 
-    class FbMoveVelocity : public FbExecAxisBufferContType
+    class FbMoveVelocity : public FbExecAxisBufferContType, public FbContinuousUpdateType
     {
     public:
         FB_INPUT LREAL mVelocity = 0;
@@ -133,6 +136,7 @@ namespace Uranus
 
     public:
         MC_ErrorCode onAxisExecPosedge(void);
+        MC_ErrorCode onAxisUpdate(void);
     };
 
     class FbReadStatus : public FbReadInfoAxisType
@@ -210,6 +214,46 @@ namespace Uranus
         MAX_JERK_APPL = 17,
     } ;
 
+    /*
+     * MC_ReadParameterMC_Parameterеı׼ֱӶȡã
+     * Ϊ첽жȡEnableڼˢ£ˢʱϴεֵ
+     */
+    class FbReadParameter : public FbReadInfoAxisType
+    {
+    public:
+        FB_INPUT MC_Parameter mParameterNumber = MC_Parameter::COMMANDED_POSITION;
+
+        FB_OUTPUT LREAL mValue = 0;
+
+    public:
+        ~FbReadParameter();
+
+        MC_ErrorCode onAxisEnable(bool &isDone);
+        void onDisable(void);
+
+    private:
+        uint32_t mRequest = 0;
+        MC_Parameter mRequestNumber = MC_Parameter::COMMANDED_POSITION;
+        bool mHasValue = false;
+    };
+
+    // MC_WriteParameterдǰBusyɺDone
+    class FbWriteParameter : public FbWriteInfoAxisType
+    {
+    public:
+        FB_INPUT MC_Parameter mParameterNumber = MC_Parameter::SWLIMIT_POS;
+        FB_INPUT LREAL mValue = 0;
+
+    public:
+        ~FbWriteParameter();
+
+        void call(void);
+        MC_ErrorCode onAxisTriggered(bool &isDone);
+
+    private:
+        uint32_t mRequest = 0;
+    };
+
     class FbReadActualPosition : public FbReadInfoAxisType
     {
     public:
@@ -0,0 +1,179 @@
+/*
+ * CycleMeter.cpp
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "CycleMeter.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Uranus
+{
+
+// 每个2的幂区间等分的桶数(2^3)
+#define URANUS_CYCLE_HISTOGRAM_SUB_BITS 3
+#define URANUS_CYCLE_HISTOGRAM_SUB_NUM (1 << URANUS_CYCLE_HISTOGRAM_SUB_BITS)
+
+    static inline uint32_t highestBit(uint64_t value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return (uint32_t)index;
+#else
+        return 63 - (uint32_t)__builtin_clzll(value);
+#endif
+    }
+
+    static inline void storeRelaxed(std::atomic<uint64_t> &dst, uint64_t value)
+    {
+        dst.store(value, std::memory_order_relaxed);
+    }
+
+    static inline uint64_t loadRelaxed(const std::atomic<uint64_t> &src)
+    {
+        return src.load(std::memory_order_relaxed);
+    }
+
+    CycleMeter::CycleMeter(bool histogram)
+    {
+        if (histogram)
+        {
+            mHistogram = new std::atomic<uint64_t>[URANUS_CYCLE_HISTOGRAM_NUM];
+            for (uint32_t i = 0; i < URANUS_CYCLE_HISTOGRAM_NUM; ++i)
+                storeRelaxed(mHistogram[i], 0);
+        }
+    }
+
+    CycleMeter::~CycleMeter()
+    {
+        delete[] mHistogram;
+    }
+
+    void CycleMeter::setBudget(uint64_t budget)
+    {
+        storeRelaxed(mBudget, budget);
+    }
+
+    uint32_t CycleMeter::bucketIndex(uint64_t cost)
+    {
+        if (cost < URANUS_CYCLE_HISTOGRAM_SUB_NUM)
+            return (uint32_t)cost;
+
+        uint32_t bit = highestBit(cost);
+        uint32_t shift = bit - URANUS_CYCLE_HISTOGRAM_SUB_BITS;
+        uint32_t sub = (uint32_t)(cost >> shift) & (URANUS_CYCLE_HISTOGRAM_SUB_NUM - 1);
+        uint32_t index = URANUS_CYCLE_HISTOGRAM_SUB_NUM + shift * URANUS_CYCLE_HISTOGRAM_SUB_NUM + sub;
+
+        return index < URANUS_CYCLE_HISTOGRAM_NUM ? index : URANUS_CYCLE_HISTOGRAM_NUM - 1;
+    }
+
+    uint64_t CycleMeter::bucketLowerBound(uint32_t index)
+    {
+        if (index < URANUS_CYCLE_HISTOGRAM_SUB_NUM)
+            return index;
+
+        uint32_t shift = (index - URANUS_CYCLE_HISTOGRAM_SUB_NUM) / URANUS_CYCLE_HISTOGRAM_SUB_NUM;
+        uint32_t sub = (index - URANUS_CYCLE_HISTOGRAM_SUB_NUM) % URANUS_CYCLE_HISTOGRAM_SUB_NUM;
+        return (uint64_t)(URANUS_CYCLE_HISTOGRAM_SUB_NUM + sub) << shift;
+    }
+
+    void CycleMeter::record(uint64_t cost)
+    {
+        if (mResetRequest.load(std::memory_order_relaxed))
+        {
+            mResetRequest.store(false, std::memory_order_relaxed);
+            clear();
+        }
+
+        // 单一写线程，无需read-modify-write
+        storeRelaxed(mLast, cost);
+        storeRelaxed(mSum, loadRelaxed(mSum) + cost);
+        if (cost < loadRelaxed(mMin))
+            storeRelaxed(mMin, cost);
+        if (cost > loadRelaxed(mMax))
+            storeRelaxed(mMax, cost);
+
+        uint64_t budget = loadRelaxed(mBudget);
+        if (budget && cost > budget)
+            storeRelaxed(mOverrunCount, loadRelaxed(mOverrunCount) + 1);
+
+        if (mHistogram)
+        {
+            std::atomic<uint64_t> &bucket = mHistogram[bucketIndex(cost)];
+            storeRelaxed(bucket, loadRelaxed(bucket) + 1);
+        }
+
+        mCount.store(loadRelaxed(mCount) + 1, std::memory_order_release);
+    }
+
+    void CycleMeter::read(CycleStatistics &stat) const
+    {
+        uint64_t count = mCount.load(std::memory_order_acquire);
+
+        stat.mCount = count;
+        stat.mOverrunCount = loadRelaxed(mOverrunCount);
+        stat.mBudget = (double)loadRelaxed(mBudget);
+        stat.mLast = (double)loadRelaxed(mLast);
+        stat.mMin = count ? (double)loadRelaxed(mMin) : 0;
+        stat.mMax = (double)loadRelaxed(mMax);
+        stat.mMean = count ? (double)loadRelaxed(mSum) / count : 0;
+    }
+
+    bool CycleMeter::readHistogram(CycleHistogram &hist) const
+    {
+        if (!mHistogram)
+            return false;
+
+        for (uint32_t i = 0; i < URANUS_CYCLE_HISTOGRAM_NUM; ++i)
+        {
+            hist.mLowerBound[i] = bucketLowerBound(i);
+            hist.mCount[i] = loadRelaxed(mHistogram[i]);
+        }
+
+        return true;
+    }
+
+    void CycleMeter::reset(void)
+    {
+        mResetRequest.store(true, std::memory_order_relaxed);
+    }
+
+    void CycleMeter::clear(void)
+    {
+        storeRelaxed(mCount, 0);
+        storeRelaxed(mOverrunCount, 0);
+        storeRelaxed(mLast, 0);
+        storeRelaxed(mMin, UINT64_MAX);
+        storeRelaxed(mMax, 0);
+        storeRelaxed(mSum, 0);
+
+        if (mHistogram)
+        {
+            for (uint32_t i = 0; i < URANUS_CYCLE_HISTOGRAM_NUM; ++i)
+                storeRelaxed(mHistogram[i], 0);
+        }
+    }
+
+}
@@ -0,0 +1,80 @@
+/*
+ * CycleMeter.h
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#ifndef _URANUS_CYCLEMETER_HPP_
+#define _URANUS_CYCLEMETER_HPP_
+
+#include "Global.h"
+
+#include <atomic>
+
+namespace Uranus
+{
+
+    /*
+     * 周期耗时统计，record()只允许单一线程调用，不分配内存、不加锁；
+     * read()可在任意线程调用，各字段单独原子读取，可能来自相邻的两个周期
+     */
+    class CycleMeter
+    {
+    public:
+        // histogram:是否统计直方图
+        explicit CycleMeter(bool histogram = false);
+        ~CycleMeter();
+
+        // 设定周期预算(ns)，0为不统计超限
+        void setBudget(uint64_t budget);
+
+        // 记录一次耗时(ns)
+        void record(uint64_t cost);
+
+        void read(CycleStatistics &stat) const;
+
+        bool readHistogram(CycleHistogram &hist) const;
+
+        // 请求清零，由下一次record()执行
+        void reset(void);
+
+        static uint32_t bucketIndex(uint64_t cost);
+
+        static uint64_t bucketLowerBound(uint32_t index);
+
+    private:
+        void clear(void);
+
+    private:
+        std::atomic<uint64_t> mBudget{0};
+        std::atomic<uint64_t> mCount{0};
+        std::atomic<uint64_t> mOverrunCount{0};
+        std::atomic<uint64_t> mLast{0};
+        std::atomic<uint64_t> mMin{UINT64_MAX};
+        std::atomic<uint64_t> mMax{0};
+        std::atomic<uint64_t> mSum{0};
+        std::atomic<bool> mResetRequest{false};
+        std::atomic<uint64_t> *mHistogram = nullptr;
+    };
+
+}
+
+#endif /** _URANUS_CYCLEMETER_HPP_ **/
@@ -26,8 +26,8 @@
 #define _URANUS_EVENT_HPP_
 
 #include <cstdint>
-#include <list>
 #include <stdio.h>
+#include <type_traits>
 
 namespace Uranus
 {
@@ -38,12 +38,86 @@ namespace Uranus
 #define URANUS_MSG(...)
 #endif
 
-// TODO: Ҫں̬ʹõģʹˣҪ
-#define URANUS_DEFINE_EVENT(Event, ...) std::list<void (*)(__VA_ARGS__)> Event;
-#define URANUS_ADD_HANDLER(Event, FuncPtr) Event.push_back(FuncPtr);
-#define URANUS_CALL_EVENT(Event, ...) \
-    for (auto &f : Event)             \
-        (*f)(__VA_ARGS__);
+// ÿ¼עĴ
+#define URANUS_EVENT_HANDLER_NUM 8
+
+    /*
+     * ¼ţעöڴ
+     * עʱĶ󣬿ԶָΪһľ̬ҲǳԱ
+     * ¼ĵһ(¼Դ)ݸ
+     */
+    template <typename Source, typename... Args>
+    class EventList
+    {
+    public:
+        template <typename C, void (*F)(C *, Args...)>
+        bool add(C *ctx)
+        {
+            return append(&staticThunk<C, F>, ctx);
+        }
+
+        template <auto M, typename C>
+        bool addMember(C *obj)
+        {
+            return append(&memberThunk<C, M>, obj);
+        }
+
+        void call(Source, Args... args) const
+        {
+            for (uint32_t i = 0; i < mNum; ++i)
+                mHandlers[i].mFunc(mHandlers[i].mCtx, args...);
+        }
+
+        uint32_t size(void) const
+        {
+            return mNum;
+        }
+
+    private:
+        typedef void (*Thunk)(void *, Args...);
+
+        struct Delegate
+        {
+            Thunk mFunc;
+            void *mCtx;
+        };
+
+        bool append(Thunk func, void *ctx)
+        {
+            if (mNum >= URANUS_EVENT_HANDLER_NUM)
+            {
+                URANUS_MSG("event handler overflow\n");
+                return false;
+            }
+
+            mHandlers[mNum].mFunc = func;
+            mHandlers[mNum].mCtx = ctx;
+            ++mNum;
+            return true;
+        }
+
+        template <typename C, void (*F)(C *, Args...)>
+        static void staticThunk(void *ctx, Args... args)
+        {
+            F(static_cast<C *>(ctx), args...);
+        }
+
+        template <typename C, auto M>
+        static void memberThunk(void *ctx, Args... args)
+        {
+            (static_cast<C *>(ctx)->*M)(args...);
+        }
+
+        Delegate mHandlers[URANUS_EVENT_HANDLER_NUM];
+        uint32_t mNum = 0;
+    };
+
+#define URANUS_DEFINE_EVENT(Event, ...) EventList<__VA_ARGS__> Event;
+#define URANUS_ADD_HANDLER(Event, FuncPtr) \
+    Event.add<std::remove_pointer<decltype(this)>::type, FuncPtr>(this);
+#define URANUS_ADD_MEMBER_HANDLER(Event, Method) \
+    Event.addMember<&std::remove_pointer<decltype(this)>::type::Method>(this);
+#define URANUS_CALL_EVENT(Event, ...) Event.call(__VA_ARGS__);
 
 }
 
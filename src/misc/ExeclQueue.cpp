@@ -23,21 +23,16 @@
  */
 
 #include "ExeclQueue.h"
-#include "Queue.h"
+#include "NodePool.h"
 
 #include <cstdint>
+#include <vector>
 
 namespace Uranus
 {
 
 #define URANUS_AXISEXECLLISTSIZE 6
-#define URANUS_AXISEXECLNODESIZE 1024
-
-    struct ExeclNodeContainer
-    {
-        ExeclNode *node = nullptr;
-        uint8_t data[URANUS_AXISEXECLNODESIZE];
-    };
+#define URANUS_AXISEXECLNODETYPENUM 4
 
     ExeclNode::ExeclNode()
     {
@@ -51,23 +46,64 @@ namespace Uranus
     {
     public:
         ExeclQueue *mThis_ = nullptr;
-        
-        Queue<ExeclNodeContainer, URANUS_AXISEXECLLISTSIZE> mQueue;
+
+        // 节点指针环形队列，节点内存来自NodePool
+        std::vector<ExeclNode *> mRing;
+        size_t mHead = 0;
+        size_t mUsed = 0;
         ExeclNode *mHoldNode = nullptr;
 
+        size_t mNodeSizes[URANUS_AXISEXECLNODETYPENUM];
+        size_t mNodeSizeNum = 0;
+
     public:
         void processFrontNode(void);
+
+        ExeclNode *at(size_t pos) const;
+        size_t position(const ExeclNode *node) const;
+        void popFront(void);
+        static void destroyNode(ExeclNode *node);
     };
 
+    ExeclNode *ExeclQueue::ExeclQueueImpl::at(size_t pos) const
+    {
+        if (pos >= mUsed)
+            return nullptr;
+
+        size_t slot = mHead + pos;
+        if (slot >= mRing.size())
+            slot -= mRing.size();
+        return mRing[slot];
+    }
+
+    size_t ExeclQueue::ExeclQueueImpl::position(const ExeclNode *node) const
+    {
+        return (node->mSlot + mRing.size() - mHead) % mRing.size();
+    }
+
+    void ExeclQueue::ExeclQueueImpl::popFront(void)
+    {
+        mRing[mHead] = nullptr;
+        if (++mHead >= mRing.size())
+            mHead = 0;
+        --mUsed;
+    }
+
+    void ExeclQueue::ExeclQueueImpl::destroyNode(ExeclNode *node)
+    {
+        void *storage = node->mStorage;
+        node->~ExeclNode();
+        NodePool::instance().deallocate(storage);
+    }
+
     void ExeclQueue::ExeclQueueImpl::processFrontNode(void)
     {
         MC_ErrorCode err;
         ExeclNodeExecStat stat = ExeclNodeExecStat::BUSY;
-        ExeclNodeContainer *container = mQueue.front();
-        if (!container)
+        ExeclNode *node = at(0);
+        if (!node)
             return;
 
-        ExeclNode *node = container->node;
         if (!node->mIsActived)
         { // 第一次Active
             err = node->onActive(mThis_);
@@ -87,16 +123,15 @@ namespace Uranus
         {
             bool isHold = false;
             node->onDone(mThis_, isHold);
+            popFront();
             if (isHold)
             { // 提交holdNode序列
                 mHoldNode = node;
             }
             else
             {
-                node->~ExeclNode();
+                destroyNode(node);
             }
-
-            mQueue.pop_front();
             break;
         }
         default:;
@@ -115,10 +150,26 @@ namespace Uranus
     {
         mImpl_ = new ExeclQueueImpl();
         mImpl_->mThis_ = this;
+        mImpl_->mRing.assign(URANUS_AXISEXECLLISTSIZE, nullptr);
     }
 
     ExeclQueue::~ExeclQueue()
     {
+        if (mImpl_->mHoldNode)
+            ExeclQueueImpl::destroyNode(mImpl_->mHoldNode);
+
+        while (mImpl_->mUsed)
+        {
+            ExeclNode *node = mImpl_->at(0);
+            mImpl_->popFront();
+            ExeclQueueImpl::destroyNode(node);
+        }
+
+        // 队列深度加一个holdNode
+        size_t depth = mImpl_->mRing.size() + 1;
+        for (size_t i = 0; i < mImpl_->mNodeSizeNum; ++i)
+            NodePool::instance().unreserve(mImpl_->mNodeSizes[i], depth);
+
         delete mImpl_;
     }
 
@@ -129,10 +180,10 @@ namespace Uranus
 
         if (mImpl_->mHoldNode)
         {
-            if (!mImpl_->mQueue.empty())
+            if (mImpl_->mUsed)
             { // 打断holdNode
                 mImpl_->mHoldNode->onAborted(this);
-                mImpl_->mHoldNode->~ExeclNode();
+                ExeclQueueImpl::destroyNode(mImpl_->mHoldNode);
                 mImpl_->mHoldNode = nullptr;
             }
             else
@@ -151,60 +202,101 @@ namespace Uranus
         return;
     }
 
-    MC_ErrorCode ExeclQueue::pushAndNewData(const std::function<ExeclNode *(void *)> &constructor, bool abortFlag)
+    MC_ErrorCode ExeclQueue::allocNode(size_t nodeSize, bool abortFlag, void *&storage)
     {
         if (abortFlag)
             setAllNodesAborted();
 
-        if (mImpl_->mQueue.push_back())
-        {
-            ExeclNodeContainer *container = mImpl_->mQueue.back();
-            container->node = constructor(container->data);
-            container->node->mContainer = container;
-            return MC_ErrorCode::GOOD;
-        }
-        else
-        {
+        if (mImpl_->mUsed >= mImpl_->mRing.size())
+            return MC_ErrorCode::QUEUEFULL;
+
+        storage = NodePool::instance().allocate(nodeSize);
+        if (!storage)
             return MC_ErrorCode::QUEUEFULL;
+
+        return MC_ErrorCode::GOOD;
+    }
+
+    void ExeclQueue::commitNode(ExeclNode *node, void *storage)
+    {
+        size_t slot = mImpl_->mHead + mImpl_->mUsed;
+        if (slot >= mImpl_->mRing.size())
+            slot -= mImpl_->mRing.size();
+
+        node->mStorage = storage;
+        node->mSlot = slot;
+        mImpl_->mRing[slot] = node;
+        ++mImpl_->mUsed;
+    }
+
+    bool ExeclQueue::setQueueDepth(size_t depth)
+    {
+        if (!depth || busy())
+            return false;
+
+        size_t oldDepth = mImpl_->mRing.size();
+        for (size_t i = 0; i < mImpl_->mNodeSizeNum; ++i)
+        {
+            if (depth > oldDepth)
+                NodePool::instance().reserve(mImpl_->mNodeSizes[i], depth - oldDepth);
+            else
+                NodePool::instance().unreserve(mImpl_->mNodeSizes[i], oldDepth - depth);
         }
+
+        mImpl_->mRing.assign(depth, nullptr);
+        mImpl_->mHead = 0;
+
+        return true;
+    }
+
+    size_t ExeclQueue::queueDepth(void) const
+    {
+        return mImpl_->mRing.size();
+    }
+
+    void ExeclQueue::reserveNode(size_t nodeSize)
+    {
+        if (mImpl_->mNodeSizeNum >= URANUS_AXISEXECLNODETYPENUM)
+            return;
+
+        mImpl_->mNodeSizes[mImpl_->mNodeSizeNum++] = nodeSize;
+        NodePool::instance().reserve(nodeSize, mImpl_->mRing.size() + 1);
     }
 
     ExeclNode *ExeclQueue::front(void) const
     {
-        ExeclNodeContainer *container = mImpl_->mQueue.front();
-        return container ? container->node : nullptr;
+        return mImpl_->at(0);
     }
 
     ExeclNode *ExeclQueue::back(void) const
     {
-        ExeclNodeContainer *container = mImpl_->mQueue.back();
-        return container ? container->node : nullptr;
+        return mImpl_->mUsed ? mImpl_->at(mImpl_->mUsed - 1) : nullptr;
     }
 
     ExeclNode *ExeclQueue::next(ExeclNode *node) const
     {
-        ExeclNodeContainer *container = node->mContainer;
-        ExeclNodeContainer *containerNext = mImpl_->mQueue.next(container);
-
-        return containerNext ? containerNext->node : nullptr;
+        return mImpl_->at(mImpl_->position(node) + 1);
     }
 
     ExeclNode *ExeclQueue::prev(ExeclNode *node) const
     {
-        ExeclNodeContainer *container = node->mContainer;
-        ExeclNodeContainer *containerPrev = mImpl_->mQueue.prev(container);
+        size_t pos = mImpl_->position(node);
+        return pos ? mImpl_->at(pos - 1) : nullptr;
+    }
 
-        return containerPrev ? containerPrev->node : nullptr;
+    ExeclNode *ExeclQueue::holdNode(void) const
+    {
+        return mImpl_->mHoldNode;
     }
 
     bool ExeclQueue::busy(void) const
     {
-        return !(mImpl_->mQueue.empty() && !mImpl_->mHoldNode);
+        return !(!mImpl_->mUsed && !mImpl_->mHoldNode);
     }
 
     size_t ExeclQueue::operationRemains(void) const
     {
-        return mImpl_->mQueue.used();
+        return mImpl_->mUsed;
     }
 
     void ExeclQueue::setAllNodesAborted(void)
@@ -212,17 +304,16 @@ namespace Uranus
         if (mImpl_->mHoldNode)
         {
             mImpl_->mHoldNode->onAborted(this);
-            mImpl_->mHoldNode->~ExeclNode();
+            ExeclQueueImpl::destroyNode(mImpl_->mHoldNode);
             mImpl_->mHoldNode = nullptr;
         }
 
-        ExeclNodeContainer *container;
-        while ((container = mImpl_->mQueue.front()))
+        ExeclNode *node;
+        while ((node = mImpl_->at(0)))
         {
-            ExeclNode *node = container->node;
             node->onAborted(this);
-            node->~ExeclNode();
-            mImpl_->mQueue.pop_front();
+            mImpl_->popFront();
+            ExeclQueueImpl::destroyNode(node);
         }
 
         URANUS_CALL_EVENT(onAllNodesAborted, this);
@@ -233,17 +324,16 @@ namespace Uranus
         if (mImpl_->mHoldNode)
         {
             mImpl_->mHoldNode->onError(this, errorCodeToSet);
-            mImpl_->mHoldNode->~ExeclNode();
+            ExeclQueueImpl::destroyNode(mImpl_->mHoldNode);
             mImpl_->mHoldNode = nullptr;
         }
 
-        ExeclNodeContainer *container;
-        while ((container = mImpl_->mQueue.front()))
+        ExeclNode *node;
+        while ((node = mImpl_->at(0)))
         {
-            ExeclNode *node = container->node;
             node->onError(this, errorCodeToSet);
-            node->~ExeclNode();
-            mImpl_->mQueue.pop_front();
+            mImpl_->popFront();
+            ExeclQueueImpl::destroyNode(node);
         }
 
         URANUS_CALL_EVENT(onAllNodesError, this, errorCodeToSet);
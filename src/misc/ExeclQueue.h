@@ -27,7 +27,8 @@
 
 #include "Global.h"
 #include "Event.h"
-#include <functional>
+#include <new>
+#include <utility>
 
 namespace Uranus
 {
@@ -39,7 +40,6 @@ namespace Uranus
         FASTDONE = 2,
     } ;
 
-    struct ExeclNodeContainer;
     class ExeclQueue;
     class ExeclNode
     {
@@ -56,7 +56,8 @@ namespace Uranus
 
     private:
         bool mIsActived = false;
-        ExeclNodeContainer *mContainer = nullptr;
+        void *mStorage = nullptr; // 节点所在的内存池块
+        size_t mSlot = 0;         // 节点在队列中的位置
         friend class ExeclQueue;
     };
 
@@ -67,28 +68,55 @@ namespace Uranus
         virtual ~ExeclQueue();
 
         void processExeclNode(void);
-        MC_ErrorCode pushAndNewData(
-            const std::function<ExeclNode *(void *)> &constructor,
-            bool abortFlag);
+
+        // 在队列尾部原位构造节点T，不经过类型擦除
+        template <typename T, typename... Args>
+        MC_ErrorCode emplace(T *&node, bool abortFlag, Args &&...args);
+
+        // 设定队列深度，只能在队列空闲时设定
+        bool setQueueDepth(size_t depth);
+        size_t queueDepth(void) const;
 
         ExeclNode *front(void) const;
         ExeclNode *back(void) const;
         ExeclNode *next(ExeclNode *node) const;
         ExeclNode *prev(ExeclNode *node) const;
+        ExeclNode *holdNode(void) const; // 已完成但保持执行的节点，不在队列中
         bool busy(void) const;
         size_t operationRemains(void) const;
         void setAllNodesAborted(void);
         void setAllNodesError(MC_ErrorCode errorCodeToSet);
 
+    protected:
+        // 登记本队列使用的节点大小，按队列深度在内存池中预留
+        void reserveNode(size_t nodeSize);
+
     protected:
         URANUS_DEFINE_EVENT(onAllNodesAborted, ExeclQueue *);
         URANUS_DEFINE_EVENT(onAllNodesError, ExeclQueue *, MC_ErrorCode);
 
+    private:
+        MC_ErrorCode allocNode(size_t nodeSize, bool abortFlag, void *&storage);
+        void commitNode(ExeclNode *node, void *storage);
+
     private:
         class ExeclQueueImpl;
         ExeclQueueImpl *mImpl_;
     };
 
+    template <typename T, typename... Args>
+    inline MC_ErrorCode ExeclQueue::emplace(T *&node, bool abortFlag, Args &&...args)
+    {
+        void *storage;
+        MC_ErrorCode err = allocNode(sizeof(T), abortFlag, storage);
+        if (MC_ErrorCode::GOOD != err)
+            return err;
+
+        node = new (storage) T(std::forward<Args>(args)...);
+        commitNode(node, storage);
+        return MC_ErrorCode::GOOD;
+    }
+
 }
 
 #endif /** _URANUS_EXECLQUEUE_HPP_ **/
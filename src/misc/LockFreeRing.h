@@ -0,0 +1,150 @@
+/*
+ * LockFreeRing.h
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#ifndef _URANUS_LOCKFREERING_HPP_
+#define _URANUS_LOCKFREERING_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * 有界多生产者多消费者无锁环形队列(Vyukov)，容量为2的幂，
+ * 存储在构造时一次分配，push/pop不分配内存、不加锁
+ */
+template <typename T>
+class LockFreeRing
+{
+private:
+    struct Cell
+    {
+        std::atomic<size_t> mSeq;
+        T mData;
+    };
+
+    // 读写位置放在不同缓存行，避免生产者与消费者互相干扰
+    alignas(64) std::atomic<size_t> mEnqueuePos{0};
+    alignas(64) std::atomic<size_t> mDequeuePos{0};
+    alignas(64) Cell *mCells = nullptr;
+    size_t mMask = 0;
+
+public:
+    explicit LockFreeRing(size_t capacity);
+    ~LockFreeRing();
+
+    LockFreeRing(const LockFreeRing &) = delete;
+    LockFreeRing &operator=(const LockFreeRing &) = delete;
+
+    bool push(const T &data);
+    bool pop(T &data);
+
+    size_t capacity(void) const;
+};
+
+template <typename T>
+inline LockFreeRing<T>::LockFreeRing(size_t capacity)
+{
+    size_t size = 2;
+    while (size < capacity)
+        size <<= 1;
+
+    mCells = new Cell[size];
+    mMask = size - 1;
+    for (size_t i = 0; i < size; ++i)
+        mCells[i].mSeq.store(i, std::memory_order_relaxed);
+}
+
+template <typename T>
+inline LockFreeRing<T>::~LockFreeRing()
+{
+    delete[] mCells;
+}
+
+template <typename T>
+inline bool LockFreeRing<T>::push(const T &data)
+{
+    Cell *cell;
+    size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+        cell = &mCells[pos & mMask];
+        size_t seq = cell->mSeq.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0)
+        {
+            if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = mEnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->mData = data;
+    cell->mSeq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+inline bool LockFreeRing<T>::pop(T &data)
+{
+    Cell *cell;
+    size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+        cell = &mCells[pos & mMask];
+        size_t seq = cell->mSeq.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (diff == 0)
+        {
+            if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = mDequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    data = cell->mData;
+    cell->mSeq.store(pos + mMask + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+inline size_t LockFreeRing<T>::capacity(void) const
+{
+    return mMask + 1;
+}
+
+#endif /** _URANUS_LOCKFREERING_HPP_ **/
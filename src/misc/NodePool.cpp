@@ -0,0 +1,226 @@
+/*
+ * NodePool.cpp
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "NodePool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace Uranus
+{
+
+// 分级粒度与最大分级大小
+#define URANUS_NODEPOOL_GRANULE 64
+#define URANUS_NODEPOOL_MAX_SIZE 4096
+#define URANUS_NODEPOOL_CLASS_NUM (URANUS_NODEPOOL_MAX_SIZE / URANUS_NODEPOOL_GRANULE)
+
+// 预留不足时每次补充的块数
+#define URANUS_NODEPOOL_GROW 8
+
+// 超出分级范围的块
+#define URANUS_NODEPOOL_HEAP_CLASS UINT32_MAX
+
+    // 块头16字节，保证数据区16字节对齐
+    struct alignas(16) BlockHeader
+    {
+        BlockHeader *mNext;
+        uint32_t mClass;
+    };
+
+    struct SizeClass
+    {
+        std::atomic_flag mLock = ATOMIC_FLAG_INIT;
+        BlockHeader *mFree = nullptr;
+        size_t mTotal = 0;
+        size_t mReserved = 0;
+        std::vector<void *> mChunks;
+
+        void lock(void)
+        {
+            while (mLock.test_and_set(std::memory_order_acquire))
+                std::this_thread::yield();
+        }
+
+        void unlock(void)
+        {
+            mLock.clear(std::memory_order_release);
+        }
+    };
+
+    class NodePool::NodePoolImpl
+    {
+    public:
+        SizeClass mClasses[URANUS_NODEPOOL_CLASS_NUM];
+
+    public:
+        static size_t blockBytes(uint32_t index);
+        void grow(uint32_t index, size_t num);
+    };
+
+    size_t NodePool::NodePoolImpl::blockBytes(uint32_t index)
+    {
+        return sizeof(BlockHeader) + (index + 1) * URANUS_NODEPOOL_GRANULE;
+    }
+
+    void NodePool::NodePoolImpl::grow(uint32_t index, size_t num)
+    {
+        SizeClass &cls = mClasses[index];
+        size_t bytes = blockBytes(index);
+        uint8_t *chunk = (uint8_t *)::operator new(bytes * num);
+        cls.mChunks.push_back(chunk);
+
+        for (size_t i = 0; i < num; ++i)
+        {
+            BlockHeader *block = (BlockHeader *)(chunk + i * bytes);
+            block->mClass = index;
+            block->mNext = cls.mFree;
+            cls.mFree = block;
+        }
+        cls.mTotal += num;
+    }
+
+    NodePool &NodePool::instance(void)
+    {
+        // 不析构，避免静态对象析构顺序导致的释放问题
+        static NodePool *pool = new NodePool();
+        return *pool;
+    }
+
+    NodePool::NodePool()
+    {
+        mImpl_ = new NodePoolImpl();
+    }
+
+    NodePool::~NodePool()
+    {
+        for (SizeClass &cls : mImpl_->mClasses)
+        {
+            for (void *chunk : cls.mChunks)
+                ::operator delete(chunk);
+        }
+        delete mImpl_;
+    }
+
+    size_t NodePool::classSize(size_t size)
+    {
+        if (!size || size > URANUS_NODEPOOL_MAX_SIZE)
+            return 0;
+
+        return (size + URANUS_NODEPOOL_GRANULE - 1) / URANUS_NODEPOOL_GRANULE * URANUS_NODEPOOL_GRANULE;
+    }
+
+    void *NodePool::allocate(size_t size)
+    {
+        size_t cs = classSize(size);
+        if (!cs)
+        {
+            BlockHeader *block = (BlockHeader *)::operator new(sizeof(BlockHeader) + size, std::nothrow);
+            if (!block)
+                return nullptr;
+
+            block->mClass = URANUS_NODEPOOL_HEAP_CLASS;
+            return block + 1;
+        }
+
+        uint32_t index = cs / URANUS_NODEPOOL_GRANULE - 1;
+        SizeClass &cls = mImpl_->mClasses[index];
+
+        cls.lock();
+        if (!cls.mFree)
+        { // 未预留时补充
+            try
+            {
+                mImpl_->grow(index, URANUS_NODEPOOL_GROW);
+            }
+            catch (const std::bad_alloc &)
+            {
+                cls.unlock();
+                return nullptr;
+            }
+        }
+
+        BlockHeader *block = cls.mFree;
+        cls.mFree = block->mNext;
+        cls.unlock();
+
+        return block + 1;
+    }
+
+    void NodePool::deallocate(void *ptr)
+    {
+        if (!ptr)
+            return;
+
+        BlockHeader *block = (BlockHeader *)ptr - 1;
+        if (block->mClass == URANUS_NODEPOOL_HEAP_CLASS)
+        {
+            ::operator delete(block);
+            return;
+        }
+
+        SizeClass &cls = mImpl_->mClasses[block->mClass];
+        cls.lock();
+        block->mNext = cls.mFree;
+        cls.mFree = block;
+        cls.unlock();
+    }
+
+    void NodePool::reserve(size_t size, size_t num)
+    {
+        size_t cs = classSize(size);
+        if (!cs || !num)
+            return;
+
+        uint32_t index = cs / URANUS_NODEPOOL_GRANULE - 1;
+        SizeClass &cls = mImpl_->mClasses[index];
+
+        cls.lock();
+        cls.mReserved += num;
+        try
+        {
+            if (cls.mTotal < cls.mReserved)
+                mImpl_->grow(index, cls.mReserved - cls.mTotal);
+        }
+        catch (const std::bad_alloc &)
+        { // 预留失败时由allocate()按需补充
+        }
+        cls.unlock();
+    }
+
+    void NodePool::unreserve(size_t size, size_t num)
+    {
+        size_t cs = classSize(size);
+        if (!cs)
+            return;
+
+        SizeClass &cls = mImpl_->mClasses[cs / URANUS_NODEPOOL_GRANULE - 1];
+        cls.lock();
+        cls.mReserved -= (num < cls.mReserved) ? num : cls.mReserved;
+        cls.unlock();
+    }
+
+} // namespace Uranus
@@ -0,0 +1,65 @@
+/*
+ * NodePool.h
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#ifndef _URANUS_NODEPOOL_HPP_
+#define _URANUS_NODEPOOL_HPP_
+
+#include <cstddef>
+
+namespace Uranus
+{
+
+    /*
+     * 全局共享的分级内存池，按64字节分级，每级一个空闲链表
+     * 预留(reserve)的块在调用时一次分配好，周期中的allocate/deallocate不再访问堆
+     */
+    class NodePool
+    {
+    public:
+        static NodePool &instance(void);
+
+        // 分配至少size字节，超出分级范围时直接从堆分配
+        void *allocate(size_t size);
+
+        // 释放allocate()返回的内存
+        void deallocate(void *ptr);
+
+        // 增加/减少size所在分级的预留块数
+        void reserve(size_t size, size_t num);
+        void unreserve(size_t size, size_t num);
+
+        // size所在分级的块大小，超出分级范围时返回0
+        static size_t classSize(size_t size);
+
+    private:
+        NodePool();
+        ~NodePool();
+
+        class NodePoolImpl;
+        NodePoolImpl *mImpl_;
+    };
+
+}
+
+#endif /** _URANUS_NODEPOOL_HPP_ **/
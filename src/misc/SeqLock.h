@@ -0,0 +1,97 @@
+/*
+ * SeqLock.h
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#ifndef _URANUS_SEQLOCK_HPP_
+#define _URANUS_SEQLOCK_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/*
+ * 单写多读的顺序锁，写入方不等待读取方，读取方在写入期间重试
+ * 数据按8字节原子字存储，读取到的始终是某一次完整写入的内容
+ */
+template <typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires trivially copyable data");
+
+private:
+    static const size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> mSeq{0};
+    std::atomic<uint64_t> mWords[WORDS];
+
+public:
+    SeqLock();
+
+    // 只允许单一线程写入
+    void store(const T &data);
+
+    void load(T &data) const;
+};
+
+template <typename T>
+inline SeqLock<T>::SeqLock()
+{
+    for (size_t i = 0; i < WORDS; ++i)
+        mWords[i].store(0, std::memory_order_relaxed);
+}
+
+template <typename T>
+inline void SeqLock<T>::store(const T &data)
+{
+    uint64_t buf[WORDS] = {0};
+    memcpy(buf, &data, sizeof(T));
+
+    uint32_t seq = mSeq.load(std::memory_order_relaxed);
+    mSeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < WORDS; ++i)
+        mWords[i].store(buf[i], std::memory_order_relaxed);
+
+    mSeq.store(seq + 2, std::memory_order_release);
+}
+
+template <typename T>
+inline void SeqLock<T>::load(T &data) const
+{
+    uint64_t buf[WORDS];
+    uint32_t seq0, seq1;
+    do
+    {
+        seq0 = mSeq.load(std::memory_order_acquire);
+        for (size_t i = 0; i < WORDS; ++i)
+            buf[i] = mWords[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        seq1 = mSeq.load(std::memory_order_relaxed);
+    } while ((seq0 & 1) || seq0 != seq1);
+
+    memcpy(&data, buf, sizeof(T));
+}
+
+#endif /** _URANUS_SEQLOCK_HPP_ **/
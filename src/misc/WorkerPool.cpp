@@ -0,0 +1,205 @@
+/*
+ * WorkerPool.cpp
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "WorkerPool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace Uranus
+{
+
+// 工作线程进入休眠前的自旋次数
+#define URANUS_WORKERPOOL_SPIN 2000
+
+    class WorkerPool::WorkerPoolImpl
+    {
+    public:
+        std::vector<std::thread> mThreads;
+        std::vector<int32_t> mCpus;
+        uint32_t mThreadNum = 1;
+
+        Task mTask = nullptr;
+        void *mCtx = nullptr;
+
+        std::atomic<uint32_t> mGeneration{0};
+        std::atomic<uint32_t> mPending{0};
+        std::atomic<bool> mExit{false};
+        std::mutex mMutex;
+        std::condition_variable mCond;
+
+    public:
+        void workerLoop(uint32_t index, uint32_t seen);
+        bool applyAffinity(uint32_t index);
+    };
+
+    void WorkerPool::WorkerPoolImpl::workerLoop(uint32_t index, uint32_t seen)
+    {
+        while (true)
+        {
+            uint32_t gen;
+            uint32_t spins = 0;
+            while ((gen = mGeneration.load(std::memory_order_acquire)) == seen &&
+                   !mExit.load(std::memory_order_acquire))
+            {
+                if (++spins < URANUS_WORKERPOOL_SPIN)
+                {
+                    std::this_thread::yield();
+                }
+                else
+                { // 长时间无任务则休眠，避免空转
+                    std::unique_lock<std::mutex> lock(mMutex);
+                    mCond.wait(lock, [this, seen]
+                               { return mGeneration.load(std::memory_order_acquire) != seen ||
+                                        mExit.load(std::memory_order_acquire); });
+                }
+            }
+
+            if (mExit.load(std::memory_order_acquire))
+                return;
+
+            seen = gen;
+            mTask(mCtx, index);
+            mPending.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    bool WorkerPool::WorkerPoolImpl::applyAffinity(uint32_t index)
+    {
+        int32_t cpu = mCpus[index];
+        if (cpu < 0 || index == 0 || index > mThreads.size())
+            return true;
+
+        std::thread &thread = mThreads[index - 1];
+
+#if defined(_WIN32)
+        return SetThreadAffinityMask((HANDLE)thread.native_handle(), (DWORD_PTR)1 << cpu) != 0;
+#elif defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#else
+        (void)thread;
+        return false;
+#endif
+    }
+
+    WorkerPool::WorkerPool()
+    {
+        mImpl_ = new WorkerPoolImpl();
+        mImpl_->mCpus.assign(1, -1);
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        stop();
+        delete mImpl_;
+    }
+
+    bool WorkerPool::start(uint32_t threadNum, Task task, void *ctx)
+    {
+        if (!threadNum || !task)
+            return false;
+
+        stop();
+
+        mImpl_->mTask = task;
+        mImpl_->mCtx = ctx;
+        mImpl_->mThreadNum = threadNum;
+        mImpl_->mCpus.resize(threadNum, -1);
+        mImpl_->mExit.store(false, std::memory_order_release);
+
+        uint32_t gen = mImpl_->mGeneration.load(std::memory_order_acquire);
+        for (uint32_t i = 1; i < threadNum; ++i)
+        {
+            mImpl_->mThreads.emplace_back(&WorkerPoolImpl::workerLoop, mImpl_, i, gen);
+            mImpl_->applyAffinity(i);
+        }
+
+        return true;
+    }
+
+    void WorkerPool::stop(void)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mImpl_->mMutex);
+            mImpl_->mExit.store(true, std::memory_order_release);
+        }
+        mImpl_->mCond.notify_all();
+
+        for (auto &thread : mImpl_->mThreads)
+            thread.join();
+
+        mImpl_->mThreads.clear();
+        mImpl_->mThreadNum = 1;
+    }
+
+    bool WorkerPool::setAffinity(uint32_t index, int32_t cpu)
+    {
+        if (index >= mImpl_->mCpus.size())
+            mImpl_->mCpus.resize(index + 1, -1);
+
+        mImpl_->mCpus[index] = cpu;
+        return mImpl_->applyAffinity(index);
+    }
+
+    uint32_t WorkerPool::threadNum(void) const
+    {
+        return mImpl_->mThreadNum;
+    }
+
+    void WorkerPool::run(void)
+    {
+        if (!mImpl_->mTask)
+            return;
+
+        if (mImpl_->mThreadNum > 1)
+        {
+            mImpl_->mPending.store(mImpl_->mThreadNum - 1, std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> lock(mImpl_->mMutex);
+                mImpl_->mGeneration.fetch_add(1, std::memory_order_release);
+            }
+            mImpl_->mCond.notify_all();
+        }
+
+        mImpl_->mTask(mImpl_->mCtx, 0);
+
+        // 等待所有工作线程完成本次分区
+        while (mImpl_->mPending.load(std::memory_order_acquire))
+            std::this_thread::yield();
+    }
+
+} // namespace Uranus
@@ -0,0 +1,66 @@
+/*
+ * WorkerPool.h
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#ifndef _URANUS_WORKERPOOL_HPP_
+#define _URANUS_WORKERPOOL_HPP_
+
+#include <cstdint>
+
+namespace Uranus
+{
+
+    /*
+     * 固定数量的常驻工作线程，每次run()为一次fork/join：
+     * 分区0在调用线程中执行，其余分区由工作线程执行，全部完成后run()返回
+     */
+    class WorkerPool
+    {
+    public:
+        typedef void (*Task)(void *ctx, uint32_t index);
+
+        WorkerPool();
+        ~WorkerPool();
+
+        // 启动线程池，threadNum包含调用run()的线程
+        bool start(uint32_t threadNum, Task task, void *ctx);
+
+        // 停止并回收所有工作线程
+        void stop(void);
+
+        // 绑定工作线程到指定CPU，cpu小于0时不绑定
+        bool setAffinity(uint32_t index, int32_t cpu);
+
+        uint32_t threadNum(void) const;
+
+        // 执行一次所有分区，阻塞到全部分区完成
+        void run(void);
+
+    private:
+        class WorkerPoolImpl;
+        WorkerPoolImpl *mImpl_;
+    };
+
+}
+
+#endif /** _URANUS_WORKERPOOL_HPP_ **/
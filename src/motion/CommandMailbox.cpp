@@ -0,0 +1,212 @@
+/*
+ * CommandMailbox.cpp
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "CommandMailbox.h"
+#include "Scheduler.h"
+#include "Axis.h"
+
+namespace Uranus
+{
+
+    void CommandMailbox::CommandProxy::onOperationActive(int32_t customId)
+    {
+        mMailbox->publish(customId, mAxisId, MC_CommandStatus::ACTIVE, MC_ErrorCode::GOOD);
+    }
+
+    void CommandMailbox::CommandProxy::onOperationAborted(int32_t customId)
+    {
+        mMailbox->publish(customId, mAxisId, MC_CommandStatus::ABORTED, MC_ErrorCode::GOOD);
+    }
+
+    void CommandMailbox::CommandProxy::onOperationDone(int32_t customId)
+    {
+        mMailbox->publish(customId, mAxisId, MC_CommandStatus::DONE, MC_ErrorCode::GOOD);
+    }
+
+    void CommandMailbox::CommandProxy::onOperationError(MC_ErrorCode errorCode, int32_t customId)
+    {
+        mMailbox->publish(customId, mAxisId, MC_CommandStatus::ERROR, errorCode);
+    }
+
+    // 运动命令加入轴队列后由代理功能块回报状态，其余命令由邮箱直接回报
+    static inline bool isMotionCommand(MC_CommandType type)
+    {
+        return type != MC_CommandType::STOP_RELEASE &&
+               type != MC_CommandType::POWER &&
+               type != MC_CommandType::RESET;
+    }
+
+    CommandMailbox::CommandMailbox(size_t capacity)
+        : mCommands(capacity), mResults(capacity * 4)
+    {
+        mPending.reserve(mCommands.capacity());
+    }
+
+    CommandMailbox::~CommandMailbox()
+    {
+    }
+
+    MC_ErrorCode CommandMailbox::post(const AxisCommand &command, int32_t &sequence)
+    {
+        // 序号为正数，作为customId随节点传递
+        int32_t seq;
+        do
+        {
+            seq = mNextSequence.fetch_add(1, std::memory_order_relaxed) & 0x7FFFFFFF;
+        } while (!seq);
+
+        if (!mCommands.push({seq, command}))
+            return MC_ErrorCode::QUEUEFULL;
+
+        sequence = seq;
+        return MC_ErrorCode::GOOD;
+    }
+
+    bool CommandMailbox::poll(AxisCommandResult &result)
+    {
+        return mResults.pop(result);
+    }
+
+    uint64_t CommandMailbox::droppedResults(void) const
+    {
+        return mDroppedResults.load(std::memory_order_relaxed);
+    }
+
+    void CommandMailbox::attach(Axis *axis)
+    {
+        CommandProxy *proxy = new CommandProxy();
+        proxy->mMailbox = this;
+        proxy->mAxisId = axis->axisId();
+        axis->mCommandProxy = proxy;
+    }
+
+    void CommandMailbox::publish(int32_t sequence, int32_t axisId, MC_CommandStatus status, MC_ErrorCode errorCode)
+    {
+        AxisCommandResult result;
+        result.mSequence = sequence;
+        result.mAxisId = axisId;
+        result.mStatus = status;
+        result.mErrorCode = errorCode;
+
+        if (!mResults.push(result))
+            mDroppedResults.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    MC_ErrorCode CommandMailbox::execute(Axis *axis, const Entry &entry, bool &isDone)
+    {
+        const AxisCommand &cmd = entry.mCommand;
+        FunctionBlock *fb = axis->mCommandProxy;
+        isDone = false;
+
+        switch (cmd.mType)
+        {
+        case MC_CommandType::MOVE_POSITION:
+            return axis->addMovePos(fb, cmd.mPosition, cmd.mVelocity, cmd.mAcceleration, cmd.mDeceleration, cmd.mJerk,
+                                    cmd.mShiftingMode, cmd.mDirection, cmd.mBufferMode, entry.mSequence);
+        case MC_CommandType::MOVE_POSITION_CONT:
+            return axis->addMovePosCont(fb, cmd.mPosition, cmd.mVelocity, cmd.mAcceleration, cmd.mDeceleration,
+                                        cmd.mEndVelocity, cmd.mJerk, cmd.mShiftingMode, cmd.mDirection,
+                                        cmd.mBufferMode, entry.mSequence);
+        case MC_CommandType::MOVE_VELOCITY:
+            return axis->addMoveVel(fb, cmd.mVelocity, cmd.mAcceleration, cmd.mDeceleration, cmd.mJerk,
+                                    cmd.mBufferMode, entry.mSequence);
+        case MC_CommandType::HALT:
+            return axis->addHalt(fb, cmd.mDeceleration, cmd.mJerk, cmd.mBufferMode, entry.mSequence);
+        case MC_CommandType::STOP:
+            return axis->addStop(fb, cmd.mDeceleration, cmd.mJerk, entry.mSequence);
+        case MC_CommandType::STOP_RELEASE:
+            axis->cancelStopLater();
+            isDone = true;
+            return MC_ErrorCode::GOOD;
+        case MC_CommandType::HOME:
+            return axis->addHoming(fb, cmd.mPosition, cmd.mBufferMode, entry.mSequence);
+        case MC_CommandType::POWER:
+            return axis->setPower(cmd.mEnable, true, true, isDone);
+        case MC_CommandType::RESET:
+            return axis->resetError(isDone);
+        default:
+            return MC_ErrorCode::PARAMETER_NOT_SUPPORT;
+        }
+    }
+
+    void CommandMailbox::dispatch(Scheduler *sched)
+    {
+        // 先推进上周期未完成的使能/复位命令
+        size_t keep = 0;
+        for (size_t i = 0; i < mPending.size(); ++i)
+        {
+            const Entry &entry = mPending[i];
+            Axis *axis = sched->axis(entry.mCommand.mAxisId);
+            if (!axis)
+            {
+                publish(entry.mSequence, entry.mCommand.mAxisId, MC_CommandStatus::ERROR, MC_ErrorCode::AXIS_NO_TEXIST);
+                continue;
+            }
+
+            bool isDone;
+            MC_ErrorCode err = execute(axis, entry, isDone);
+            if (err != MC_ErrorCode::GOOD)
+                publish(entry.mSequence, entry.mCommand.mAxisId, MC_CommandStatus::ERROR, err);
+            else if (isDone)
+                publish(entry.mSequence, entry.mCommand.mAxisId, MC_CommandStatus::DONE, err);
+            else
+                mPending[keep++] = entry;
+        }
+        mPending.resize(keep);
+
+        // 每周期最多处理一个队列容量的新命令，避免投递方持续写入时无法退出
+        Entry entry;
+        for (size_t n = mCommands.capacity(); n && mCommands.pop(entry); --n)
+        {
+            int32_t axisId = entry.mCommand.mAxisId;
+            Axis *axis = sched->axis(axisId);
+            if (!axis)
+            {
+                publish(entry.mSequence, axisId, MC_CommandStatus::ERROR, MC_ErrorCode::AXIS_NO_TEXIST);
+                continue;
+            }
+
+            bool isDone;
+            MC_ErrorCode err = execute(axis, entry, isDone);
+            if (err != MC_ErrorCode::GOOD)
+            {
+                publish(entry.mSequence, axisId, MC_CommandStatus::ERROR, err);
+            }
+            else if (!isMotionCommand(entry.mCommand.mType))
+            {
+                if (isDone)
+                    publish(entry.mSequence, axisId, MC_CommandStatus::DONE, err);
+                else if (mPending.size() < mPending.capacity())
+                    mPending.push_back(entry);
+                else
+                    publish(entry.mSequence, axisId, MC_CommandStatus::ERROR, MC_ErrorCode::QUEUEFULL);
+            }
+            else
+            {
+                publish(entry.mSequence, axisId, MC_CommandStatus::ACCEPTED, err);
+            }
+        }
+    }
+
+}
@@ -0,0 +1,97 @@
+/*
+ * CommandMailbox.h
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#ifndef _URANUS_COMMANDMAILBOX_HPP_
+#define _URANUS_COMMANDMAILBOX_HPP_
+
+#include "Global.h"
+#include "FunctionBlock.h"
+#include "LockFreeRing.h"
+
+#include <vector>
+
+namespace Uranus
+{
+
+    class Axis;
+    class Scheduler;
+
+    /*
+     * 非实时线程与周期线程之间的命令邮箱：
+     * post()/poll()可在任意线程调用，dispatch()只在runCycle中调用
+     */
+    class CommandMailbox
+    {
+    public:
+        explicit CommandMailbox(size_t capacity);
+        ~CommandMailbox();
+
+        // 投递命令，sequence返回命令序号
+        MC_ErrorCode post(const AxisCommand &command, int32_t &sequence);
+
+        // 取出一条命令结果，无结果时返回false
+        bool poll(AxisCommandResult &result);
+
+        // 结果队列满而丢弃的结果数
+        uint64_t droppedResults(void) const;
+
+        // 为轴创建结果代理，代理由轴的持有者释放
+        void attach(Axis *axis);
+
+        // 执行所有已投递的命令
+        void dispatch(Scheduler *sched);
+
+    private:
+        struct Entry
+        {
+            int32_t mSequence;
+            AxisCommand mCommand;
+        };
+
+        class CommandProxy : public FunctionBlock
+        {
+        public:
+            CommandMailbox *mMailbox = nullptr;
+            int32_t mAxisId = 0;
+
+            void onOperationActive(int32_t customId) override;
+            void onOperationAborted(int32_t customId) override;
+            void onOperationDone(int32_t customId) override;
+            void onOperationError(MC_ErrorCode errorCode, int32_t customId) override;
+        };
+
+        MC_ErrorCode execute(Axis *axis, const Entry &entry, bool &isDone);
+        void publish(int32_t sequence, int32_t axisId, MC_CommandStatus status, MC_ErrorCode errorCode);
+
+    private:
+        LockFreeRing<Entry> mCommands;
+        LockFreeRing<AxisCommandResult> mResults;
+        std::atomic<int32_t> mNextSequence{1};
+        std::atomic<uint64_t> mDroppedResults{0};
+        std::vector<Entry> mPending; // 需要多周期完成的使能/复位命令
+    };
+
+}
+
+#endif /** _URANUS_COMMANDMAILBOX_HPP_ **/
@@ -0,0 +1,302 @@
+/*
+ * CycleRunner.cpp
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "CycleRunner.h"
+#include "Scheduler.h"
+#include "CycleMeter.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+#endif
+
+namespace Uranus
+{
+
+    class CycleRunner::CycleRunnerImpl
+    {
+    public:
+        struct CallbackItem
+        {
+            Callback mCallback;
+            void *mCtx;
+        };
+
+        Scheduler *mSched = nullptr;
+        int32_t mPriority = 0;
+        int32_t mCpu = -1;
+        bool mMemoryLock = false;
+        std::vector<CallbackItem> mCallbacks;
+
+        std::atomic<bool> mRunning{false};
+        std::atomic<bool> mExit{false};
+        std::thread mThread;
+        CycleMeter mMeter{true};
+
+    public:
+        static uint64_t now(void);
+        static void sleepUntil(uint64_t deadline);
+        MC_ErrorCode setup(void);
+        void loop(void);
+    };
+
+#if defined(__linux__)
+    uint64_t CycleRunner::CycleRunnerImpl::now(void)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    }
+
+    void CycleRunner::CycleRunnerImpl::sleepUntil(uint64_t deadline)
+    {
+        struct timespec ts;
+        ts.tv_sec = deadline / 1000000000ULL;
+        ts.tv_nsec = deadline % 1000000000ULL;
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+            ;
+    }
+#else
+    uint64_t CycleRunner::CycleRunnerImpl::now(void)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    void CycleRunner::CycleRunnerImpl::sleepUntil(uint64_t deadline)
+    {
+        std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(deadline))));
+    }
+#endif
+
+    MC_ErrorCode CycleRunner::CycleRunnerImpl::setup(void)
+    {
+#if defined(__linux__)
+        if (mMemoryLock && mlockall(MCL_CURRENT | MCL_FUTURE))
+            return MC_ErrorCode::CFG_MEMORY_LOCK_FAILED;
+
+        if (mCpu >= 0)
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(mCpu, &set);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set))
+                return MC_ErrorCode::CFG_CPU_AFFINITY_ILLEGAL;
+        }
+
+        if (mPriority > 0)
+        {
+            struct sched_param param;
+            param.sched_priority = mPriority;
+            if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param))
+                return MC_ErrorCode::CFG_RT_PRIORITY_ILLEGAL;
+        }
+#elif defined(_WIN32)
+        if (mMemoryLock)
+            return MC_ErrorCode::CFG_MEMORY_LOCK_FAILED;
+
+        if (mCpu >= 0 && !SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << mCpu))
+            return MC_ErrorCode::CFG_CPU_AFFINITY_ILLEGAL;
+
+        if (mPriority > 0 && !SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL))
+            return MC_ErrorCode::CFG_RT_PRIORITY_ILLEGAL;
+#else
+        if (mMemoryLock)
+            return MC_ErrorCode::CFG_MEMORY_LOCK_FAILED;
+        if (mCpu >= 0)
+            return MC_ErrorCode::CFG_CPU_AFFINITY_ILLEGAL;
+        if (mPriority > 0)
+            return MC_ErrorCode::CFG_RT_PRIORITY_ILLEGAL;
+#endif
+        return MC_ErrorCode::GOOD;
+    }
+
+    void CycleRunner::CycleRunnerImpl::loop(void)
+    {
+        uint64_t period = (uint64_t)(1e9 / mSched->frequency());
+        mMeter.setBudget(period);
+
+        uint64_t deadline = now() + period;
+        while (!mExit.load(std::memory_order_acquire))
+        {
+            sleepUntil(deadline);
+
+            uint64_t wakeup = now();
+            mMeter.record(wakeup > deadline ? wakeup - deadline : 0);
+
+            mSched->runCycle();
+
+            bool keep = true;
+            for (auto &item : mCallbacks)
+                keep = item.mCallback(item.mCtx) && keep;
+            if (!keep)
+                break;
+
+            // 按绝对时间推进，错过的周期直接跳过
+            deadline += period;
+            uint64_t current = now();
+            if (current > deadline)
+                deadline += (current - deadline) / period * period + period;
+        }
+    }
+
+    CycleRunner::CycleRunner(Scheduler *sched)
+    {
+        mImpl_ = new CycleRunnerImpl();
+        mImpl_->mSched = sched;
+    }
+
+    CycleRunner::~CycleRunner()
+    {
+        stop();
+        delete mImpl_;
+    }
+
+    MC_ErrorCode CycleRunner::setPriority(int32_t priority)
+    {
+        if (priority < 0 || priority > 99)
+            return MC_ErrorCode::CFG_RT_PRIORITY_ILLEGAL;
+
+        if (isRunning())
+            return MC_ErrorCode::AXIS_BUSY;
+
+        mImpl_->mPriority = priority;
+        return MC_ErrorCode::GOOD;
+    }
+
+    MC_ErrorCode CycleRunner::setAffinity(int32_t cpu)
+    {
+        if (isRunning())
+            return MC_ErrorCode::AXIS_BUSY;
+
+        mImpl_->mCpu = cpu < 0 ? -1 : cpu;
+        return MC_ErrorCode::GOOD;
+    }
+
+    MC_ErrorCode CycleRunner::setMemoryLock(bool lock)
+    {
+        if (isRunning())
+            return MC_ErrorCode::AXIS_BUSY;
+
+        mImpl_->mMemoryLock = lock;
+        return MC_ErrorCode::GOOD;
+    }
+
+    MC_ErrorCode CycleRunner::addCallback(Callback callback, void *ctx)
+    {
+        if (!callback)
+            return MC_ErrorCode::PARAMETER_NOT_SUPPORT;
+
+        if (isRunning())
+            return MC_ErrorCode::AXIS_BUSY;
+
+        mImpl_->mCallbacks.push_back({callback, ctx});
+        return MC_ErrorCode::GOOD;
+    }
+
+    MC_ErrorCode CycleRunner::run(void)
+    {
+        if (!mImpl_->mSched)
+            return MC_ErrorCode::PARAMETER_NOT_SUPPORT;
+
+        if (mImpl_->mRunning.exchange(true))
+            return MC_ErrorCode::AXIS_BUSY;
+
+        mImpl_->mExit.store(false, std::memory_order_release);
+        MC_ErrorCode err = mImpl_->setup();
+        if (err == MC_ErrorCode::GOOD)
+            mImpl_->loop();
+        mImpl_->mRunning.store(false, std::memory_order_release);
+
+        return err;
+    }
+
+    MC_ErrorCode CycleRunner::start(void)
+    {
+        if (!mImpl_->mSched)
+            return MC_ErrorCode::PARAMETER_NOT_SUPPORT;
+
+        if (mImpl_->mRunning.exchange(true))
+            return MC_ErrorCode::AXIS_BUSY;
+
+        // 上次循环已自行结束(回调返回false)，回收遗留的线程
+        if (mImpl_->mThread.joinable())
+            mImpl_->mThread.join();
+
+        mImpl_->mExit.store(false, std::memory_order_release);
+
+        // 线程属性只能在运行线程内设定，等待设定结果后返回
+        std::promise<MC_ErrorCode> setupResult;
+        std::future<MC_ErrorCode> future = setupResult.get_future();
+        mImpl_->mThread = std::thread([this, &setupResult]
+                                      {
+            MC_ErrorCode err = mImpl_->setup();
+            setupResult.set_value(err);
+            if (err == MC_ErrorCode::GOOD)
+                mImpl_->loop();
+            mImpl_->mRunning.store(false, std::memory_order_release); });
+
+        MC_ErrorCode err = future.get();
+        if (err != MC_ErrorCode::GOOD)
+            mImpl_->mThread.join();
+
+        return err;
+    }
+
+    void CycleRunner::stop(void)
+    {
+        mImpl_->mExit.store(true, std::memory_order_release);
+        if (mImpl_->mThread.joinable())
+            mImpl_->mThread.join();
+    }
+
+    bool CycleRunner::isRunning(void) const
+    {
+        return mImpl_->mRunning.load(std::memory_order_acquire);
+    }
+
+    void CycleRunner::readLatency(CycleStatistics &stat) const
+    {
+        mImpl_->mMeter.read(stat);
+    }
+
+    void CycleRunner::readLatencyHistogram(CycleHistogram &hist) const
+    {
+        mImpl_->mMeter.readHistogram(hist);
+    }
+
+}
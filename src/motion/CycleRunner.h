@@ -0,0 +1,103 @@
+/*
+ * CycleRunner.h
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#ifndef _URANUS_CYCLERUNNER_HPP_
+#define _URANUS_CYCLERUNNER_HPP_
+
+#include "Global.h"
+
+namespace Uranus
+{
+
+#pragma pack(push)
+#pragma pack(4)
+
+    class Scheduler;
+
+    /*
+     * 实时周期驱动，按绝对截止时间(CLOCK_MONOTONIC)唤醒，
+     * 每周期执行一次Scheduler::runCycle，之后按注册顺序调用回调，
+     * 周期执行时间不累积到下一周期；错过的截止时间直接跳过，不补执行
+     */
+    class CycleRunner
+    {
+    public:
+        // 周期回调，返回false时停止运行
+        typedef bool (*Callback)(void *ctx);
+
+        explicit CycleRunner(Scheduler *sched);
+
+        virtual ~CycleRunner();
+
+        /*
+         * 设定SCHED_FIFO优先级，在run()开始时生效
+         * priority:1~99，0为不修改调度策略
+         */
+        MC_ErrorCode setPriority(int32_t priority);
+
+        // 将运行线程绑定到指定CPU，小于0时不绑定
+        MC_ErrorCode setAffinity(int32_t cpu);
+
+        // 是否在run()开始时调用mlockall锁定内存
+        MC_ErrorCode setMemoryLock(bool lock);
+
+        // 注册周期回调，运行中不可修改
+        MC_ErrorCode addCallback(Callback callback, void *ctx);
+
+        // 注册可调用对象，对象须在运行期间有效
+        template <typename F>
+        MC_ErrorCode addCallback(F &func)
+        {
+            return addCallback([](void *ctx) -> bool
+                               { return (*static_cast<F *>(ctx))(); },
+                               &func);
+        }
+
+        // 在当前线程运行，直到回调返回false或调用stop()
+        MC_ErrorCode run(void);
+
+        // 在新线程中运行
+        MC_ErrorCode start(void);
+
+        // 停止运行，由start()启动时等待线程退出
+        void stop(void);
+
+        bool isRunning(void) const;
+
+        // 读取唤醒延迟统计(ns)，超限预算为一个周期
+        void readLatency(CycleStatistics &stat) const;
+
+        // 读取唤醒延迟直方图
+        void readLatencyHistogram(CycleHistogram &hist) const;
+
+    private:
+        class CycleRunnerImpl;
+        CycleRunnerImpl *mImpl_;
+    };
+
+#pragma pack(pop)
+
+}
+
+#endif /** _URANUS_CYCLERUNNER_HPP_ **/
@@ -38,9 +38,19 @@ namespace Uranus
 #define URANUS_CARTESIAN_DIMENSION3 3
 #define URANUS_CARTESIAN_DIMENSION6 6
 #define URANUS_TRANSITIONPARAMETER_NUM 4
+#define URANUS_CYCLE_HISTOGRAM_NUM 272
 
     typedef uint32_t MC_ServoErrorCode;
 
+    // 异步参数请求的状态
+    enum class ServoValStat
+    {
+        NONE = 0,  // 请求不存在或已被取走
+        BUSY = 1,  // 排队或执行中
+        DONE = 2,  // 完成
+        ERROR = 3, // 驱动器拒绝或不支持
+    };
+
     enum class MC_ServoControlMode
     {
         POSITION = 0,
@@ -98,6 +108,16 @@ namespace Uranus
         CFG_PKP_ILLEGAL = 0x207,
         CFG_FEED_FORWORD_ILLEGAL = 0x208,
         CFG_MODULO_ILLEGAL = 0x209,
+        CFG_THREAD_NUM_ILLEGAL = 0x20A,
+        CFG_PARTITION_ILLEGAL = 0x20B,
+        CFG_RT_PRIORITY_ILLEGAL = 0x20C,
+        CFG_CPU_AFFINITY_ILLEGAL = 0x20D,
+        CFG_MEMORY_LOCK_FAILED = 0x20E,
+        CFG_DIVISOR_ILLEGAL = 0x20F,
+        CFG_QUEUE_DEPTH_ILLEGAL = 0x216,
+        CFG_PLAN_CACHE_SIZE_ILLEGAL = 0x217,
+        CFG_SHM_OPEN_FAILED = 0x218,     // 共享内存映像创建或映射失败
+        CFG_SHM_LAYOUT_ILLEGAL = 0x219,  // 共享内存映像格式或站数不符
 
         HOMING_VEL_ILLEGAL = 0x210,
         HOMING_ACC_ILLEGAL = 0x211,
@@ -234,6 +254,28 @@ namespace Uranus
         MAX_CORNER_DEVIATION = 4,
     };
 
+    enum class MC_CommandType
+    {
+        MOVE_POSITION = 0,      // 位置运动，绝对/相对/叠加由mShiftingMode区分
+        MOVE_POSITION_CONT = 1, // 带终速度的位置运动
+        MOVE_VELOCITY = 2,      // 速度运动
+        HALT = 3,               // 暂停
+        STOP = 4,               // 急停，轴保持STOPPING直到STOP_RELEASE
+        STOP_RELEASE = 5,       // 解除STOP
+        HOME = 6,               // 回零
+        POWER = 7,              // 使能/去使能，由mEnable指定
+        RESET = 8,              // 复位错误
+    };
+
+    enum class MC_CommandStatus
+    {
+        ACCEPTED = 0, // 已加入轴队列
+        ACTIVE = 1,
+        DONE = 2,
+        ABORTED = 3,
+        ERROR = 4,
+    };
+
     enum class MC_LogLevel
     {
         ERROR = 0,
@@ -307,6 +349,91 @@ namespace Uranus
         //    GroupMotionLimitInfo mMotionLimitInfo;
     };
 
+    //////////////////////////////////////////////////////////////
+
+    struct AxisCommand
+    {
+        int32_t mAxisId = 0;                                       // 目标轴Id
+        MC_CommandType mType = MC_CommandType::MOVE_POSITION;      // 命令类型
+        double mPosition = 0;                                      // 目标位置/距离
+        double mVelocity = 0;                                      // 速度
+        double mAcceleration = 0;                                  // 加速度
+        double mDeceleration = 0;                                  // 减速度
+        double mJerk = 0;                                          // 加加速度
+        double mEndVelocity = 0;                                   // 终速度，仅MOVE_POSITION_CONT有效
+        MC_ShiftingMode mShiftingMode = MC_ShiftingMode::ABSOLUTE; // 位置模式
+        MC_Direction mDirection = MC_Direction::CURRENT;           // 运动方向
+        MC_BufferMode mBufferMode = MC_BufferMode::ABORTING;       // 缓冲模式
+        bool mEnable = false;                                      // 使能状态，仅POWER有效
+    };
+
+    struct AxisCommandResult
+    {
+        int32_t mSequence = 0;                            // postCommand返回的序号
+        int32_t mAxisId = 0;                              // 目标轴Id
+        MC_CommandStatus mStatus = MC_CommandStatus::DONE; // 命令状态
+        MC_ErrorCode mErrorCode = MC_ErrorCode::GOOD;     // 错误码，仅ERROR有效
+    };
+
+    struct AxisSnapshot
+    {
+        uint32_t mTick = 0;                                // 发布时的调度器tick
+        int32_t mAxisId = 0;                               // 轴Id
+        MC_AxisStatus mStatus = MC_AxisStatus::DISABLED;   // 轴状态
+        MC_ErrorCode mErrorCode = MC_ErrorCode::GOOD;      // 轴错误码
+        MC_ServoErrorCode mDevErrorCode = 0;               // 驱动器错误码
+        bool mPowerStatus = false;                         // 使能状态
+        double mCmdPosition = 0;                           // 指令位置
+        double mCmdVelocity = 0;                           // 指令速度
+        double mCmdAcceleration = 0;                       // 指令加速度
+        double mActPosition = 0;                           // 实际位置
+        double mActVelocity = 0;                           // 实际速度
+        double mActAcceleration = 0;                       // 实际加速度
+        double mActTorque = 0;                             // 实际力矩
+    };
+
+    //////////////////////////////////////////////////////////////
+
+    struct CycleStatistics
+    {
+        uint64_t mCount = 0;        // 统计周期数
+        uint64_t mOverrunCount = 0; // 超出周期预算的次数
+        double mBudget = 0;         // 周期预算(ns)，0为不统计超限
+        double mLast = 0;           // 最近一次耗时(ns)
+        double mMin = 0;            // 最小耗时(ns)
+        double mMax = 0;            // 最大耗时(ns)
+        double mMean = 0;           // 平均耗时(ns)
+    };
+
+    struct SimStatistics
+    {
+        uint32_t mInstances = 0;     // 调度器实例数
+        uint32_t mThreads = 0;       // 并行线程数
+        uint64_t mCycles = 0;        // 所有实例累计执行的周期数
+        double mSimTime = 0;         // 所有实例累计的仿真时间(s)
+        double mWallTime = 0;        // 实际耗时(s)
+        double mCyclesPerSecond = 0; // 每秒实际时间执行的仿真周期数
+        double mRealtimeFactor = 0;  // 累计仿真时间与实际耗时之比
+    };
+
+    /*
+     * 对数-线性分布的耗时直方图，每个2的幂区间再等分为8个桶，
+     * 相对误差不超过12.5%，覆盖0~2^36ns
+     */
+    struct CycleHistogram
+    {
+        uint64_t mLowerBound[URANUS_CYCLE_HISTOGRAM_NUM] = {0}; // 桶下界(ns)
+        uint64_t mCount[URANUS_CYCLE_HISTOGRAM_NUM] = {0};      // 落入该桶的周期数
+    };
+
+    struct PlanCacheStatistics
+    {
+        uint64_t mHits = 0;   // 命中次数
+        uint64_t mMisses = 0; // 未命中次数
+        uint32_t mSize = 0;   // 缓存条目数，0为未启用
+        uint32_t mUsed = 0;   // 已使用的条目数
+    };
+
 #pragma pack(pop)
 
 }
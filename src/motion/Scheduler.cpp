@@ -24,36 +24,282 @@
 
 #include "Scheduler.h"
 #include "Axis.h"
+#include "WorkerPool.h"
+#include "CycleMeter.h"
+#include "CommandMailbox.h"
+#include "PlanWorker.h"
+#include "ProfileBatch.h"
+#include "ServoBus.h"
+
+#include <cfloat>
+#include <chrono>
+#include <memory>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
 
 namespace Uranus
 {
 
+// 并行执行的最大线程数
+#define URANUS_MAX_THREAD_NUM 64
+// 轴Id在[0, URANUS_AXIS_DIRECT_INDEX_SIZE)内时直接下标索引，其余Id使用哈希表
+#define URANUS_AXIS_DIRECT_INDEX_SIZE 4096
+// 轴的最大分频系数
+#define URANUS_MAX_AXIS_DIVISOR 1024
+// 轴运动队列的最大深度
+#define URANUS_MAX_AXIS_QUEUE_DEPTH 1024
+// 轴路径缓存的最大条目数
+#define URANUS_MAX_AXIS_PLAN_CACHE_SIZE 256
+// 命令邮箱容量
+#define URANUS_COMMAND_MAILBOX_SIZE 256
+
 class Scheduler::SchedulerImpl
 {
   public:
-    Axis mAxisHead;
+    Scheduler *mThis_;
+    std::vector<Axis *> mAxes;
+    std::vector<Axis *> mAxisDirectIndex;
+    std::unordered_map<int32_t, Axis *> mAxisHashIndex;
     double mFreq = 1000.0;
     uint32_t mTick = 0;
+
+    WorkerPool mPool;
+    uint32_t mThreadNum = 1;
+    std::vector<std::vector<Axis *>> mPartitions;
+
+    bool mStatisticsEnable = true;
+    CycleMeter mMeter{true};
+    CommandMailbox mMailbox{URANUS_COMMAND_MAILBOX_SIZE};
+    PlanWorker mPlanWorker;
+    ServoBus *mBus = nullptr;
+
+    bool mBatchEnable = false;
+    std::unique_ptr<ProfileBatch> mBatch;
+
+  public:
+    static uint64_t now(void);
+    void runAxes(const std::vector<Axis *> &axes);
+    void publishSnapshot(Axis *axis, uint32_t tick);
+    Axis *findAxis(int32_t axisId) const;
+    void addAxis(Axis *axis);
+    uint32_t choosePhase(const Axis *axis, uint32_t divisor) const;
+    void rebuildPartitions(void);
+    void rebuildBatch(void);
+    static void runPartition(void *ctx, uint32_t index);
 };
 
+inline Axis *Scheduler::SchedulerImpl::findAxis(int32_t axisId) const
+{
+    if (axisId >= 0 && axisId < URANUS_AXIS_DIRECT_INDEX_SIZE)
+        return (size_t)axisId < mAxisDirectIndex.size() ? mAxisDirectIndex[axisId] : nullptr;
+
+    auto it = mAxisHashIndex.find(axisId);
+    return it != mAxisHashIndex.end() ? it->second : nullptr;
+}
+
+void Scheduler::SchedulerImpl::addAxis(Axis *axis)
+{
+    int32_t axisId = axis->mAxisId;
+    if (axisId >= 0 && axisId < URANUS_AXIS_DIRECT_INDEX_SIZE)
+    {
+        if ((size_t)axisId >= mAxisDirectIndex.size())
+            mAxisDirectIndex.resize(axisId + 1, nullptr);
+        mAxisDirectIndex[axisId] = axis;
+    }
+    else
+    {
+        mAxisHashIndex[axisId] = axis;
+    }
+
+    // 保持与原轴链表一致的顺序，新建的轴排在最前
+    mAxes.insert(mAxes.begin(), axis);
+    for (size_t i = 0; i < mAxes.size(); ++i)
+        mAxes[i]->mIndex = (uint32_t)i;
+}
+
+uint32_t Scheduler::SchedulerImpl::choosePhase(const Axis *axis, uint32_t divisor) const
+{
+    // 两轴相位在gcd下同余时每lcm个tick重合一次，选择与已有分频轴重合代价最小的相位
+    uint32_t best = 0;
+    double bestCost = DBL_MAX;
+    for (uint32_t phase = 0; phase < divisor; ++phase)
+    {
+        double cost = 0;
+        for (const Axis *other : mAxes)
+        {
+            if (other == axis || other->mDivisor == 1)
+                continue;
+
+            uint32_t g = std::gcd(divisor, other->mDivisor);
+            if (phase % g == other->mPhase % g)
+                cost += (double)g / ((double)divisor * other->mDivisor);
+        }
+
+        if (cost < bestCost)
+        {
+            bestCost = cost;
+            best = phase;
+        }
+    }
+
+    return best;
+}
+
+void Scheduler::SchedulerImpl::rebuildPartitions(void)
+{
+    mPartitions.assign(mThreadNum, std::vector<Axis *>());
+    std::vector<double> load(mThreadNum, 0.0);
+
+    // 先放置固定分区的轴，保证耦合轴在同一线程内按轴列表顺序执行
+    for (Axis *axis : mAxes)
+    {
+        if (axis->mPartition >= 0)
+        {
+            size_t index = axis->mPartition % mThreadNum;
+            mPartitions[index].push_back(axis);
+            load[index] += 1.0 / axis->mDivisor;
+        }
+    }
+
+    // 其余轴按平均每tick负载分配到负载最小的分区
+    for (Axis *axis : mAxes)
+    {
+        if (axis->mPartition < 0)
+        {
+            size_t best = 0;
+            for (size_t i = 1; i < mPartitions.size(); ++i)
+            {
+                if (load[i] < load[best])
+                    best = i;
+            }
+            mPartitions[best].push_back(axis);
+            load[best] += 1.0 / axis->mDivisor;
+        }
+    }
+}
+
+void Scheduler::SchedulerImpl::rebuildBatch(void)
+{
+    for (Axis *axis : mAxes)
+        axis->setProfileBatch(nullptr, 0);
+    mBatch.reset();
+
+    if (!mBatchEnable)
+        return;
+
+    // 只有每个tick都执行的轴才能逐tick取用批量结果
+    uint32_t laneNum = 0;
+    for (Axis *axis : mAxes)
+    {
+        if (axis->mDivisor == 1)
+            ++laneNum;
+    }
+
+    mBatch.reset(new ProfileBatch(laneNum));
+    uint32_t lane = 0;
+    for (Axis *axis : mAxes)
+    {
+        if (axis->mDivisor == 1)
+            axis->setProfileBatch(mBatch.get(), lane++);
+    }
+}
+
+inline uint64_t Scheduler::SchedulerImpl::now(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void Scheduler::SchedulerImpl::runAxes(const std::vector<Axis *> &axes)
+{
+    uint32_t tick = mTick;
+    if (!mStatisticsEnable)
+    {
+        for (Axis *axis : axes)
+        {
+            if (axis->mDivisor == 1 || tick % axis->mDivisor == axis->mPhase)
+            {
+                axis->runCycle();
+                publishSnapshot(axis, tick);
+            }
+        }
+        return;
+    }
+
+    // 相邻两轴共用一次取时，每轴只增加一次时钟读取
+    uint64_t last = now();
+    for (Axis *axis : axes)
+    {
+        if (axis->mDivisor != 1 && tick % axis->mDivisor != axis->mPhase)
+            continue;
+
+        axis->runCycle();
+        publishSnapshot(axis, tick);
+        uint64_t current = now();
+        axis->mMeter.record(current - last);
+        last = current;
+    }
+}
+
+void Scheduler::SchedulerImpl::publishSnapshot(Axis *axis, uint32_t tick)
+{
+    AxisSnapshot snapshot;
+    snapshot.mTick = tick;
+    snapshot.mAxisId = axis->mAxisId;
+    snapshot.mStatus = axis->status();
+    snapshot.mErrorCode = axis->errorCode();
+    snapshot.mDevErrorCode = axis->devErrorCode();
+    snapshot.mPowerStatus = axis->powerStatus();
+    snapshot.mCmdPosition = axis->cmdPosition();
+    snapshot.mCmdVelocity = axis->cmdVelocity();
+    snapshot.mCmdAcceleration = axis->cmdAcceleration();
+    snapshot.mActPosition = axis->actPosition();
+    snapshot.mActVelocity = axis->actVelocity();
+    snapshot.mActAcceleration = axis->actAcceleration();
+    snapshot.mActTorque = axis->actTorque();
+    axis->mSnapshot.store(snapshot);
+}
+
+void Scheduler::SchedulerImpl::runPartition(void *ctx, uint32_t index)
+{
+    SchedulerImpl *impl = static_cast<SchedulerImpl *>(ctx);
+    impl->runAxes(impl->mPartitions[index]);
+}
+
 Scheduler::Scheduler()
 {
     mImpl_ = new SchedulerImpl();
+    mImpl_->mThis_ = this;
+    mImpl_->mMeter.setBudget((uint64_t)(1e9 / mImpl_->mFreq));
 }
 
 Scheduler::~Scheduler()
 {
+    setAsyncPlanning(false);
     delete mImpl_;
 }
 
 void Scheduler::runCycle(void)
 {
-    Axis *axis = axisListFirst();
-    while (axis)
-    {
-        axis->runCycle();
-        axis = axisListNext(axis);
-    }
+    uint64_t start = mImpl_->mStatisticsEnable ? SchedulerImpl::now() : 0;
+
+    mImpl_->mMailbox.dispatch(this);
+
+    if (mImpl_->mBatch)
+        mImpl_->mBatch->step();
+
+    if (mImpl_->mThreadNum > 1)
+        mImpl_->mPool.run();
+    else
+        mImpl_->runAxes(mImpl_->mAxes);
+
+    if (mImpl_->mBus)
+        mImpl_->mBus->exchange(mImpl_->mFreq);
+
+    if (mImpl_->mStatisticsEnable)
+        mImpl_->mMeter.record(SchedulerImpl::now() - start);
 
     ++mImpl_->mTick;
 }
@@ -63,10 +309,11 @@ MC_ErrorCode Scheduler::setFrequency(double frequency)
     if (frequency <= 0)
         return MC_ErrorCode::FREQUENCY_ILLEGAL;
 
-    if (axisListFirst())
+    if (!mImpl_->mAxes.empty())
         return MC_ErrorCode::AXIS_BUSY;
 
     mImpl_->mFreq = frequency;
+    mImpl_->mMeter.setBudget((uint64_t)(1e9 / frequency));
 
     return MC_ErrorCode::GOOD;
 }
@@ -81,9 +328,226 @@ uint32_t Scheduler::tick(void) const
     return mImpl_->mTick;
 }
 
+MC_ErrorCode Scheduler::setThreadNum(uint32_t threadNum)
+{
+    if (!threadNum || threadNum > URANUS_MAX_THREAD_NUM)
+        return MC_ErrorCode::CFG_THREAD_NUM_ILLEGAL;
+
+    if (threadNum == mImpl_->mThreadNum)
+        return MC_ErrorCode::GOOD;
+
+    mImpl_->mPool.stop();
+    mImpl_->mThreadNum = threadNum;
+    mImpl_->rebuildPartitions();
+
+    if (threadNum > 1)
+        mImpl_->mPool.start(threadNum, SchedulerImpl::runPartition, mImpl_);
+
+    return MC_ErrorCode::GOOD;
+}
+
+uint32_t Scheduler::threadNum(void) const
+{
+    return mImpl_->mThreadNum;
+}
+
+MC_ErrorCode Scheduler::setThreadAffinity(uint32_t threadIndex, int32_t cpu)
+{
+    if (!threadIndex || threadIndex >= URANUS_MAX_THREAD_NUM)
+        return MC_ErrorCode::CFG_THREAD_NUM_ILLEGAL;
+
+    if (!mImpl_->mPool.setAffinity(threadIndex, cpu))
+        return MC_ErrorCode::PARAMETER_NOT_SUPPORT;
+
+    return MC_ErrorCode::GOOD;
+}
+
+MC_ErrorCode Scheduler::setAxisPartition(Axis *axis, int32_t partition)
+{
+    if (!axis)
+        return MC_ErrorCode::AXIS_NO_TEXIST;
+
+    if (partition >= URANUS_MAX_THREAD_NUM)
+        return MC_ErrorCode::CFG_PARTITION_ILLEGAL;
+
+    axis->mPartition = partition < 0 ? -1 : partition;
+    mImpl_->rebuildPartitions();
+
+    return MC_ErrorCode::GOOD;
+}
+
+MC_ErrorCode Scheduler::postCommand(const AxisCommand &command, int32_t &sequence)
+{
+    return mImpl_->mMailbox.post(command, sequence);
+}
+
+bool Scheduler::pollCommandResult(AxisCommandResult &result)
+{
+    return mImpl_->mMailbox.poll(result);
+}
+
+MC_ErrorCode Scheduler::readAxisSnapshot(const Axis *axis, AxisSnapshot &snapshot) const
+{
+    if (!axis)
+        return MC_ErrorCode::AXIS_NO_TEXIST;
+
+    axis->mSnapshot.load(snapshot);
+    return MC_ErrorCode::GOOD;
+}
+
+uint32_t Scheduler::readAllSnapshots(AxisSnapshot *snapshots, uint32_t num) const
+{
+    uint32_t count = 0;
+    for (Axis *axis : mImpl_->mAxes)
+    {
+        if (count >= num)
+            break;
+        axis->mSnapshot.load(snapshots[count++]);
+    }
+
+    return count;
+}
+
+void Scheduler::setStatisticsEnable(bool enable)
+{
+    mImpl_->mStatisticsEnable = enable;
+}
+
+void Scheduler::readStatistics(CycleStatistics &stat) const
+{
+    mImpl_->mMeter.read(stat);
+}
+
+void Scheduler::readHistogram(CycleHistogram &hist) const
+{
+    mImpl_->mMeter.readHistogram(hist);
+}
+
+MC_ErrorCode Scheduler::readAxisStatistics(const Axis *axis, CycleStatistics &stat) const
+{
+    if (!axis)
+        return MC_ErrorCode::AXIS_NO_TEXIST;
+
+    axis->mMeter.read(stat);
+    return MC_ErrorCode::GOOD;
+}
+
+MC_ErrorCode Scheduler::setAxisPlanCache(Axis *axis, uint32_t size)
+{
+    if (!axis)
+        return MC_ErrorCode::AXIS_NO_TEXIST;
+
+    if (size > URANUS_MAX_AXIS_PLAN_CACHE_SIZE)
+        return MC_ErrorCode::CFG_PLAN_CACHE_SIZE_ILLEGAL;
+
+    if (!axis->setPlanCacheSize(size))
+        return MC_ErrorCode::AXIS_BUSY;
+
+    return MC_ErrorCode::GOOD;
+}
+
+MC_ErrorCode Scheduler::readAxisPlanCacheStatistics(const Axis *axis, PlanCacheStatistics &stat) const
+{
+    if (!axis)
+        return MC_ErrorCode::AXIS_NO_TEXIST;
+
+    axis->readPlanCacheStatistics(stat);
+    return MC_ErrorCode::GOOD;
+}
+
+void Scheduler::resetStatistics(void)
+{
+    mImpl_->mMeter.reset();
+    for (Axis *axis : mImpl_->mAxes)
+    {
+        axis->mMeter.reset();
+        axis->resetPlanCacheStatistics();
+    }
+}
+
+MC_ErrorCode Scheduler::setAxisDivisor(Axis *axis, uint32_t divisor)
+{
+    if (!axis)
+        return MC_ErrorCode::AXIS_NO_TEXIST;
+
+    if (!divisor || divisor > URANUS_MAX_AXIS_DIVISOR)
+        return MC_ErrorCode::CFG_DIVISOR_ILLEGAL;
+
+    MC_AxisStatus status = axis->status();
+    if (status != MC_AxisStatus::DISABLED && status != MC_AxisStatus::STANDSTILL)
+        return MC_ErrorCode::AXIS_BUSY;
+
+    axis->mDivisor = divisor;
+    axis->mPhase = mImpl_->choosePhase(axis, divisor);
+    mImpl_->rebuildPartitions();
+    mImpl_->rebuildBatch();
+
+    return MC_ErrorCode::GOOD;
+}
+
+MC_ErrorCode Scheduler::setAxisQueueDepth(Axis *axis, uint32_t depth)
+{
+    if (!axis)
+        return MC_ErrorCode::AXIS_NO_TEXIST;
+
+    if (!depth || depth > URANUS_MAX_AXIS_QUEUE_DEPTH)
+        return MC_ErrorCode::CFG_QUEUE_DEPTH_ILLEGAL;
+
+    if (!axis->setQueueDepth(depth))
+        return MC_ErrorCode::AXIS_BUSY;
+
+    return MC_ErrorCode::GOOD;
+}
+
+MC_ErrorCode Scheduler::setAxisLookAhead(Axis *axis, bool enable)
+{
+    if (!axis)
+        return MC_ErrorCode::AXIS_NO_TEXIST;
+
+    axis->setLookAhead(enable);
+    return MC_ErrorCode::GOOD;
+}
+
+MC_ErrorCode Scheduler::setAsyncPlanning(bool enable, int32_t cpu)
+{
+    if (enable)
+    {
+        if (!mImpl_->mPlanWorker.start(cpu))
+            return MC_ErrorCode::PARAMETER_NOT_SUPPORT;
+
+        for (Axis *axis : mImpl_->mAxes)
+            axis->setPlanWorker(&mImpl_->mPlanWorker);
+    }
+    else
+    {
+        for (Axis *axis : mImpl_->mAxes)
+            axis->setPlanWorker(nullptr);
+
+        mImpl_->mPlanWorker.stop();
+    }
+
+    return MC_ErrorCode::GOOD;
+}
+
+bool Scheduler::asyncPlanning(void) const
+{
+    return mImpl_->mPlanWorker.isRunning();
+}
+
+void Scheduler::setBatchStepping(bool enable)
+{
+    mImpl_->mBatchEnable = enable;
+    mImpl_->rebuildBatch();
+}
+
+bool Scheduler::batchStepping(void) const
+{
+    return mImpl_->mBatchEnable;
+}
+
 Axis *Scheduler::newAxis(int32_t axisId, Servo *servo)
 {
-    if (axis(axisId))
+    if (mImpl_->findAxis(axisId))
         return nullptr;
 
     Axis *newAxis = new Axis();
@@ -93,22 +557,30 @@ Axis *Scheduler::newAxis(int32_t axisId, Servo *servo)
     newAxis->setServo(servo);
     newAxis->mSched = this;
     newAxis->mAxisId = axisId;
-    newAxis->insertBack(&mImpl_->mAxisHead);
+    mImpl_->addAxis(newAxis);
+    mImpl_->mMailbox.attach(newAxis);
+    if (mImpl_->mPlanWorker.isRunning())
+        newAxis->setPlanWorker(&mImpl_->mPlanWorker);
+    mImpl_->publishSnapshot(newAxis, mImpl_->mTick);
+    mImpl_->rebuildPartitions();
+    mImpl_->rebuildBatch();
 
     return newAxis;
 }
 
-Axis *Scheduler::axis(int32_t axisId) const
+void Scheduler::setServoBus(ServoBus *bus)
 {
-    Axis *axis = axisListFirst();
-    while (axis)
-    {
-        if (axis->mAxisId == axisId)
-            return axis;
-        axis = axisListNext(axis);
-    }
+    mImpl_->mBus = bus;
+}
 
-    return nullptr;
+ServoBus *Scheduler::servoBus(void) const
+{
+    return mImpl_->mBus;
+}
+
+Axis *Scheduler::axis(int32_t axisId) const
+{
+    return mImpl_->findAxis(axisId);
 }
 
 MC_ErrorCode Scheduler::setAxisConfig(Axis *axis, const AxisConfig &config)
@@ -141,22 +613,30 @@ MC_ErrorCode Scheduler::setAxisHomePosition(Axis *axis, double homePos)
 
 Axis *Scheduler::axisListFirst(void) const
 {
-    return dynamic_cast<Axis *>(mImpl_->mAxisHead.LinkNode::next());
+    return mImpl_->mAxes.empty() ? nullptr : mImpl_->mAxes.front();
 }
 
 Axis *Scheduler::axisListNext(const Axis *one) const
 {
-    return dynamic_cast<Axis *>(one->LinkNode::next());
+    size_t index = one->mIndex + 1;
+    return index < mImpl_->mAxes.size() ? mImpl_->mAxes[index] : nullptr;
 }
 
 void Scheduler::release(void)
 {
-    LinkNode *node;
-    while ((node = axisListFirst()))
+    for (Axis *axis : mImpl_->mAxes)
     {
-        node->takeOut();
-        delete node;
+        // 轴析构时可能回报命令中止，代理最后释放
+        FunctionBlock *proxy = axis->mCommandProxy;
+        delete axis;
+        delete proxy;
     }
+
+    mImpl_->mAxes.clear();
+    mImpl_->mAxisDirectIndex.clear();
+    mImpl_->mAxisHashIndex.clear();
+    mImpl_->rebuildPartitions();
+    mImpl_->rebuildBatch();
 }
 
 } // namespace Uranus
@@ -35,6 +35,7 @@ namespace Uranus
 #pragma pack(4)
 
     class Axis;
+    class ServoBus;
     class Scheduler
     {
     public:
@@ -54,6 +55,120 @@ namespace Uranus
         // 当前tick，每次runCycle后自增
         uint32_t tick(void) const;
 
+        /*
+         * 设定runCycle并行执行的线程数
+         * threadNum:分区数，包含调用runCycle的线程，1为串行执行
+         * 每个分区由一个常驻线程执行，本周期所有分区完成后runCycle才返回
+         */
+        MC_ErrorCode setThreadNum(uint32_t threadNum);
+
+        // 获取并行线程数
+        uint32_t threadNum(void) const;
+
+        /*
+         * 将工作线程绑定到指定CPU
+         * threadIndex:分区号，分区0为调用runCycle的线程，不能在此绑定
+         * cpu:CPU编号，小于0时不绑定
+         */
+        MC_ErrorCode setThreadAffinity(uint32_t threadIndex, int32_t cpu);
+
+        /*
+         * 将轴固定到指定分区，存在耦合关系的轴应固定到同一分区，
+         * 同一分区内的轴保持轴列表中的先后顺序执行
+         * partition:分区号，小于0时自动分配
+         */
+        MC_ErrorCode setAxisPartition(Axis *axis, int32_t partition);
+
+        /*
+         * 设定轴的分频系数，轴每divisor个tick执行一次，轴的规划频率为frequency/divisor
+         * 同分频的轴自动错开执行相位，使每周期负载均匀
+         * 只能在轴未使能或静止时设定
+         */
+        MC_ErrorCode setAxisDivisor(Axis *axis, uint32_t divisor);
+
+        /*
+         * 设定轴的运动队列深度(默认6)，节点内存从共享内存池中按深度预留
+         * 只能在轴队列空闲时设定
+         */
+        MC_ErrorCode setAxisQueueDepth(Axis *axis, uint32_t depth);
+
+        /*
+         * 开关轴的速度前瞻，开启后缓冲的定位运动之间以不停止的最大速度衔接
+         * 前瞻范围为轴的运动队列深度
+         */
+        MC_ErrorCode setAxisLookAhead(Axis *axis, bool enable);
+
+        /*
+         * 开关异步规划，开启后由后台线程提前规划各轴缓冲的运动节点，
+         * 节点开始执行时周期线程只拷贝规划结果，预规划未完成或起始状态不符时仍同步规划
+         * cpu:规划线程绑定的CPU，小于0时不绑定
+         */
+        MC_ErrorCode setAsyncPlanning(bool enable, int32_t cpu = -1);
+
+        bool asyncPlanning(void) const;
+
+        /*
+         * 开关批量步进，开启后每周期先以一次向量化计算步进所有轴的运动轨迹，
+         * 轴执行时直接取用结果；段切换与重新规划的周期仍由轴单独计算，结果与逐轴步进逐位相同
+         * 分频系数大于1的轴不参与批量步进，不可在runCycle执行期间调用
+         */
+        void setBatchStepping(bool enable);
+
+        bool batchStepping(void) const;
+
+        /*
+         * 从非周期线程投递轴命令，命令在下一次runCycle开始时执行
+         * 无锁，可在多个线程中同时调用
+         * sequence:返回命令序号，与命令结果中的mSequence对应
+         */
+        MC_ErrorCode postCommand(const AxisCommand &command, int32_t &sequence);
+
+        /*
+         * 取出一条命令结果，无结果时返回false
+         * 运动命令依次回报ACCEPTED/ACTIVE/DONE(或ABORTED/ERROR)，其余命令完成时回报DONE
+         */
+        bool pollCommandResult(AxisCommandResult &result);
+
+        /*
+         * 读取轴在最近一次执行后发布的状态快照
+         * 可在非实时线程中调用，不加锁，各字段来自同一周期
+         */
+        MC_ErrorCode readAxisSnapshot(const Axis *axis, AxisSnapshot &snapshot) const;
+
+        /*
+         * 按轴列表顺序读取所有轴的状态快照
+         * 返回:实际读取的轴数量
+         */
+        uint32_t readAllSnapshots(AxisSnapshot *snapshots, uint32_t num) const;
+
+        // 启用/禁用周期耗时统计，默认启用
+        void setStatisticsEnable(bool enable);
+
+        /*
+         * 读取runCycle的耗时统计，超限预算为1/frequency
+         * 可在非实时线程中调用，不加锁
+         */
+        void readStatistics(CycleStatistics &stat) const;
+
+        // 读取runCycle的耗时直方图
+        void readHistogram(CycleHistogram &hist) const;
+
+        // 读取单个轴每周期的耗时统计
+        MC_ErrorCode readAxisStatistics(const Axis *axis, CycleStatistics &stat) const;
+
+        /*
+         * 设定轴的路径缓存条目数(默认0，不缓存)，相同相对位移与速度参数的运动复用路径计算结果
+         * 开启异步规划时预规划与同步规划共用该缓存
+         * 只能在轴队列空闲时设定
+         */
+        MC_ErrorCode setAxisPlanCache(Axis *axis, uint32_t size);
+
+        // 读取轴的路径缓存命中统计
+        MC_ErrorCode readAxisPlanCacheStatistics(const Axis *axis, PlanCacheStatistics &stat) const;
+
+        // 清零所有统计，在下一周期生效
+        void resetStatistics(void);
+
         /*
          * 新建轴
          * axisId:轴Id，不重复
@@ -62,6 +177,14 @@ namespace Uranus
          */
         Axis *newAxis(int32_t axisId, Servo *servo);
 
+        /*
+         * 设定过程映像伺服总线，每周期所有轴执行完成后调用一次bus->exchange
+         * 轴通过bus->newServo创建，总线不由调度器释放，nullptr为不使用总线
+         */
+        void setServoBus(ServoBus *bus);
+
+        ServoBus *servoBus(void) const;
+
         // 通过Id获取轴
         Axis *axis(int32_t axisId) const;
 
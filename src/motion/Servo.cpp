@@ -28,6 +28,22 @@
 namespace Uranus
 {
 
+// 每个伺服的参数请求队列容量
+#define URANUS_SERVO_VAL_QUEUE_SIZE 8
+// 每周期最多执行的参数请求步数
+#define URANUS_SERVO_VAL_STEPS 4
+
+    struct ServoValRequest
+    {
+        uint32_t mId = 0; // 0为空闲
+        int mIndex = 0;
+        double mValue = 0;
+        ServoValStat mStat = ServoValStat::NONE;
+        bool mWrite = false;
+        bool mStarted = false;
+        bool mCancelled = false;
+    };
+
     class Servo::ServoImpl
     {
     public:
@@ -35,8 +51,68 @@ namespace Uranus
         int32_t mPos = 0;
         double mVel = 0;
         double mAcc = 0;
+
+        ServoValRequest mRequests[URANUS_SERVO_VAL_QUEUE_SIZE];
+        uint32_t mNextId = 1;
+
+    public:
+        bool post(bool write, int index, double value, uint32_t &request);
+        ServoValRequest *find(uint32_t request);
+        ServoValRequest *oldestBusy(void);
     };
 
+    bool Servo::ServoImpl::post(bool write, int index, double value, uint32_t &request)
+    {
+        for (ServoValRequest &req : mRequests)
+        {
+            if (req.mId)
+                continue;
+
+            req.mId = mNextId++;
+            if (!mNextId)
+                mNextId = 1;
+            req.mIndex = index;
+            req.mValue = value;
+            req.mStat = ServoValStat::BUSY;
+            req.mWrite = write;
+            req.mStarted = req.mCancelled = false;
+            request = req.mId;
+            return true;
+        }
+
+        return false;
+    }
+
+    ServoValRequest *Servo::ServoImpl::find(uint32_t request)
+    {
+        if (!request)
+            return nullptr;
+
+        for (ServoValRequest &req : mRequests)
+        {
+            if (req.mId == request)
+                return &req;
+        }
+
+        return nullptr;
+    }
+
+    ServoValRequest *Servo::ServoImpl::oldestBusy(void)
+    {
+        // 按提交顺序执行，请求号回绕时以与mNextId的距离比较
+        ServoValRequest *oldest = nullptr;
+        for (ServoValRequest &req : mRequests)
+        {
+            if (!req.mId || ServoValStat::BUSY != req.mStat)
+                continue;
+
+            if (!oldest || (uint32_t)(mNextId - req.mId) > (uint32_t)(mNextId - oldest->mId))
+                oldest = &req;
+        }
+
+        return oldest;
+    }
+
     Servo::Servo()
     {
         mImpl_ = new ServoImpl();
@@ -120,4 +196,75 @@ namespace Uranus
         mImpl_->mVel = mImpl_->mAcc = 0;
     }
 
+    bool Servo::readValAsync(int index, uint32_t &request)
+    {
+        return mImpl_->post(false, index, 0, request);
+    }
+
+    bool Servo::writeValAsync(int index, double value, uint32_t &request)
+    {
+        return mImpl_->post(true, index, value, request);
+    }
+
+    ServoValStat Servo::pollVal(uint32_t request, double &value)
+    {
+        ServoValRequest *req = mImpl_->find(request);
+        if (!req || req->mCancelled)
+            return ServoValStat::NONE;
+
+        ServoValStat stat = req->mStat;
+        if (ServoValStat::BUSY != stat)
+        {
+            value = req->mValue;
+            req->mId = 0;
+        }
+
+        return stat;
+    }
+
+    void Servo::cancelVal(uint32_t request)
+    {
+        ServoValRequest *req = mImpl_->find(request);
+        if (!req)
+            return;
+
+        if (ServoValStat::BUSY == req->mStat && req->mStarted)
+            req->mCancelled = true;
+        else
+            req->mId = 0;
+    }
+
+    void Servo::processValRequests(void)
+    {
+        // 回收已结束且被放弃的请求槽
+        for (ServoValRequest &req : mImpl_->mRequests)
+        {
+            if (req.mId && req.mCancelled && ServoValStat::BUSY != req.mStat)
+                req.mId = 0;
+        }
+
+        for (int i = 0; i < URANUS_SERVO_VAL_STEPS; ++i)
+        {
+            ServoValRequest *req = mImpl_->oldestBusy();
+            if (!req)
+                return;
+
+            bool start = !req->mStarted;
+            req->mStarted = true;
+            ServoValStat stat = stepVal(req->mWrite, req->mIndex, req->mValue, start);
+            if (ServoValStat::BUSY == stat)
+                return; // 执行中的请求占用本周期
+
+            req->mStat = stat;
+            if (req->mCancelled)
+                req->mId = 0;
+        }
+    }
+
+    ServoValStat Servo::stepVal(bool write, int index, double &value, bool start)
+    {
+        bool ok = write ? writeVal(index, value) : readVal(index, value);
+        return ok ? ServoValStat::DONE : ServoValStat::ERROR;
+    }
+
 } // namespace Uranus
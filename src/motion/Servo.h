@@ -54,6 +54,32 @@ namespace Uranus
         virtual void runCycle(double freq);
         virtual void emergStop(void);
 
+        /*
+         * 异步参数访问，请求排队后在之后的周期中分步执行，不阻塞周期
+         * 与轴的周期在同一线程中调用
+         * request:返回请求号，用于pollVal查询
+         * 返回:队列已满时返回false
+         */
+        bool readValAsync(int index, uint32_t &request);
+        bool writeValAsync(int index, double value, uint32_t &request);
+
+        // 查询请求结果，返回DONE/ERROR后请求被释放，读请求的结果由value返回
+        ServoValStat pollVal(uint32_t request, double &value);
+
+        // 取消请求，已开始执行的请求执行完成后结果被丢弃
+        void cancelVal(uint32_t request);
+
+        // 执行参数请求队列，由轴在每周期runCycle之后调用，每周期的执行步数有上限
+        void processValRequests(void);
+
+    protected:
+        /*
+         * 执行一个参数请求的一步，start为true时为该请求的第一步
+         * 返回BUSY时下一周期继续执行同一请求，返回DONE/ERROR时请求完成
+         * 默认实现同步调用readVal/writeVal
+         */
+        virtual ServoValStat stepVal(bool write, int index, double &value, bool start);
+
     private:
         class ServoImpl;
         ServoImpl *mImpl_;
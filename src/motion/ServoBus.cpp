@@ -0,0 +1,386 @@
+/*
+ * ServoBus.cpp
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "ServoBus.h"
+
+#include <cstring>
+#include <vector>
+
+namespace Uranus
+{
+
+    // 映像中每个数组按8字节对齐
+    static inline size_t alignArray(size_t size)
+    {
+        return (size + 7) & ~(size_t)7;
+    }
+
+    static void mapInput(ServoBusInput &image, void *mem, uint32_t num)
+    {
+        uint8_t *p = (uint8_t *)mem;
+        image.mTorque = (double *)p;
+        p += alignArray(sizeof(double) * num);
+        image.mPos = (int32_t *)p;
+        p += alignArray(sizeof(int32_t) * num);
+        image.mVel = (int32_t *)p;
+        p += alignArray(sizeof(int32_t) * num);
+        image.mAcc = (int32_t *)p;
+        p += alignArray(sizeof(int32_t) * num);
+        image.mErrorCode = (MC_ServoErrorCode *)p;
+        p += alignArray(sizeof(MC_ServoErrorCode) * num);
+        image.mStatusWord = (uint16_t *)p;
+    }
+
+    static void mapOutput(ServoBusOutput &image, void *mem, uint32_t num)
+    {
+        uint8_t *p = (uint8_t *)mem;
+        image.mTorque = (double *)p;
+        p += alignArray(sizeof(double) * num);
+        image.mPos = (int32_t *)p;
+        p += alignArray(sizeof(int32_t) * num);
+        image.mVel = (int32_t *)p;
+        p += alignArray(sizeof(int32_t) * num);
+        image.mControlWord = (uint16_t *)p;
+        p += alignArray(sizeof(uint16_t) * num);
+        image.mMode = (ServoBusMode *)p;
+    }
+
+    size_t ServoBus::inputImageSize(uint32_t slaveNum)
+    {
+        return alignArray(sizeof(double) * slaveNum) + alignArray(sizeof(int32_t) * slaveNum) * 3 +
+               alignArray(sizeof(MC_ServoErrorCode) * slaveNum) + alignArray(sizeof(uint16_t) * slaveNum);
+    }
+
+    size_t ServoBus::outputImageSize(uint32_t slaveNum)
+    {
+        return alignArray(sizeof(double) * slaveNum) + alignArray(sizeof(int32_t) * slaveNum) * 2 +
+               alignArray(sizeof(uint16_t) * slaveNum) + alignArray(sizeof(ServoBusMode) * slaveNum);
+    }
+
+    // 轴持有的代理伺服，只读写过程映像中自己的一列
+    class ServoBusSlave : public Servo
+    {
+    public:
+        ServoBus *mBus;
+        uint32_t mIndex;
+
+    public:
+        ServoBusSlave(ServoBus *bus, uint32_t index) : mBus(bus), mIndex(index) {}
+        ~ServoBusSlave();
+
+        MC_ServoErrorCode setPower(bool powerStatus, bool &isDone) override;
+        MC_ServoErrorCode setPos(int32_t pos) override;
+        MC_ServoErrorCode setVel(int32_t vel) override;
+        MC_ServoErrorCode setTorque(double torque) override;
+        int32_t pos(void) override;
+        int32_t vel(void) override;
+        int32_t acc(void) override;
+        double torque(void) override;
+        bool readVal(int index, double &value) override;
+        bool writeVal(int index, double value) override;
+        MC_ServoErrorCode resetError(bool &isDone) override;
+        void runCycle(double freq) override {}
+        void emergStop(void) override;
+
+    protected:
+        ServoValStat stepVal(bool write, int index, double &value, bool start) override;
+    };
+
+    class ServoBus::ServoBusImpl
+    {
+    public:
+        uint32_t mSlaveNum = 0;
+
+        std::vector<uint64_t> mInputMem;
+        std::vector<uint64_t> mOutputMem;
+        ServoBusInput mInput;
+        ServoBusOutput mOutput;
+
+        std::vector<ServoBusSlave *> mSlaves;
+
+        // 环回模式下的站点状态
+        std::vector<double> mLoopVel;
+        std::vector<double> mLoopAcc;
+    };
+
+    ServoBusSlave::~ServoBusSlave()
+    {
+        if (mBus)
+            mBus->mImpl_->mSlaves[mIndex] = nullptr;
+    }
+
+    MC_ServoErrorCode ServoBusSlave::setPower(bool powerStatus, bool &isDone)
+    {
+        if (!mBus)
+            return 0xFFFFFFFF;
+
+        const ServoBusInput &in = mBus->mImpl_->mInput;
+        uint16_t &cw = mBus->mImpl_->mOutput.mControlWord[mIndex];
+
+        if (powerStatus)
+            cw |= URANUS_SERVOBUS_CW_ENABLE;
+        else
+            cw &= ~URANUS_SERVOBUS_CW_ENABLE;
+
+        if (in.mStatusWord[mIndex] & URANUS_SERVOBUS_SW_FAULT)
+            return in.mErrorCode[mIndex];
+
+        isDone = !!(in.mStatusWord[mIndex] & URANUS_SERVOBUS_SW_ENABLED) == powerStatus;
+        return 0;
+    }
+
+    MC_ServoErrorCode ServoBusSlave::setPos(int32_t pos)
+    {
+        if (!mBus)
+            return 0xFFFFFFFF;
+
+        mBus->mImpl_->mOutput.mPos[mIndex] = pos;
+        mBus->mImpl_->mOutput.mMode[mIndex] = ServoBusMode::POSITION;
+        return mBus->mImpl_->mInput.mErrorCode[mIndex];
+    }
+
+    MC_ServoErrorCode ServoBusSlave::setVel(int32_t vel)
+    {
+        if (!mBus)
+            return 0xFFFFFFFF;
+
+        mBus->mImpl_->mOutput.mVel[mIndex] = vel;
+        mBus->mImpl_->mOutput.mMode[mIndex] = ServoBusMode::VELOCITY;
+        return mBus->mImpl_->mInput.mErrorCode[mIndex];
+    }
+
+    MC_ServoErrorCode ServoBusSlave::setTorque(double torque)
+    {
+        if (!mBus)
+            return 0xFFFFFFFF;
+
+        mBus->mImpl_->mOutput.mTorque[mIndex] = torque;
+        mBus->mImpl_->mOutput.mMode[mIndex] = ServoBusMode::TORQUE;
+        return mBus->mImpl_->mInput.mErrorCode[mIndex];
+    }
+
+    int32_t ServoBusSlave::pos(void)
+    {
+        return mBus ? mBus->mImpl_->mInput.mPos[mIndex] : 0;
+    }
+
+    int32_t ServoBusSlave::vel(void)
+    {
+        return mBus ? mBus->mImpl_->mInput.mVel[mIndex] : 0;
+    }
+
+    int32_t ServoBusSlave::acc(void)
+    {
+        return mBus ? mBus->mImpl_->mInput.mAcc[mIndex] : 0;
+    }
+
+    double ServoBusSlave::torque(void)
+    {
+        return mBus ? mBus->mImpl_->mInput.mTorque[mIndex] : 0;
+    }
+
+    bool ServoBusSlave::readVal(int index, double &value)
+    {
+        return mBus ? mBus->readVal(mIndex, index, value) : false;
+    }
+
+    bool ServoBusSlave::writeVal(int index, double value)
+    {
+        return mBus ? mBus->writeVal(mIndex, index, value) : false;
+    }
+
+    MC_ServoErrorCode ServoBusSlave::resetError(bool &isDone)
+    {
+        if (!mBus)
+            return 0xFFFFFFFF;
+
+        const ServoBusInput &in = mBus->mImpl_->mInput;
+        uint16_t &cw = mBus->mImpl_->mOutput.mControlWord[mIndex];
+
+        // 复位请求保持到站点清除故障
+        isDone = !(in.mStatusWord[mIndex] & URANUS_SERVOBUS_SW_FAULT);
+        if (isDone)
+            cw &= ~(URANUS_SERVOBUS_CW_RESET | URANUS_SERVOBUS_CW_QUICKSTOP);
+        else
+            cw |= URANUS_SERVOBUS_CW_RESET;
+
+        return 0;
+    }
+
+    void ServoBusSlave::emergStop(void)
+    {
+        if (mBus)
+            mBus->mImpl_->mOutput.mControlWord[mIndex] |= URANUS_SERVOBUS_CW_QUICKSTOP;
+    }
+
+    ServoValStat ServoBusSlave::stepVal(bool write, int index, double &value, bool start)
+    {
+        return mBus ? mBus->stepVal(mIndex, write, index, value, start) : ServoValStat::ERROR;
+    }
+
+    /////////////////////////////////////////////////////////////
+
+    ServoBus::ServoBus(uint32_t slaveNum)
+    {
+        mImpl_ = new ServoBusImpl();
+        mImpl_->mSlaveNum = slaveNum;
+        mImpl_->mInputMem.assign(inputImageSize(slaveNum) / sizeof(uint64_t), 0);
+        mImpl_->mOutputMem.assign(outputImageSize(slaveNum) / sizeof(uint64_t), 0);
+        mapInput(mImpl_->mInput, mImpl_->mInputMem.data(), slaveNum);
+        mapOutput(mImpl_->mOutput, mImpl_->mOutputMem.data(), slaveNum);
+        mImpl_->mSlaves.assign(slaveNum, nullptr);
+        mImpl_->mLoopVel.assign(slaveNum, 0);
+        mImpl_->mLoopAcc.assign(slaveNum, 0);
+    }
+
+    ServoBus::~ServoBus()
+    {
+        // 仍被轴持有的代理不再访问映像
+        for (ServoBusSlave *slave : mImpl_->mSlaves)
+        {
+            if (slave)
+                slave->mBus = nullptr;
+        }
+
+        delete mImpl_;
+    }
+
+    uint32_t ServoBus::slaveNum(void) const
+    {
+        return mImpl_->mSlaveNum;
+    }
+
+    Servo *ServoBus::newServo(uint32_t index)
+    {
+        if (index >= mImpl_->mSlaveNum || mImpl_->mSlaves[index])
+            return nullptr;
+
+        ServoBusSlave *slave = new ServoBusSlave(this, index);
+        mImpl_->mSlaves[index] = slave;
+        return slave;
+    }
+
+    const ServoBusInput &ServoBus::input(void) const
+    {
+        return mImpl_->mInput;
+    }
+
+    const ServoBusOutput &ServoBus::output(void) const
+    {
+        return mImpl_->mOutput;
+    }
+
+    void ServoBus::exchange(double freq)
+    {
+        ServoBusInput &in = mImpl_->mInput;
+        ServoBusOutput &out = mImpl_->mOutput;
+
+        for (uint32_t i = 0; i < mImpl_->mSlaveNum; ++i)
+        {
+            uint16_t cw = out.mControlWord[i];
+
+            if (cw & URANUS_SERVOBUS_CW_ENABLE)
+                in.mStatusWord[i] |= URANUS_SERVOBUS_SW_ENABLED;
+            else
+                in.mStatusWord[i] &= ~URANUS_SERVOBUS_SW_ENABLED;
+
+            int32_t target;
+            switch (out.mMode[i])
+            {
+            case ServoBusMode::POSITION:
+                target = out.mPos[i];
+                break;
+
+            case ServoBusMode::VELOCITY:
+                target = in.mPos[i] + (int32_t)(out.mVel[i] / freq);
+                break;
+
+            case ServoBusMode::TORQUE:
+            default:
+                target = in.mPos[i];
+                break;
+            }
+
+            if (cw & URANUS_SERVOBUS_CW_QUICKSTOP)
+            {
+                mImpl_->mLoopVel[i] = mImpl_->mLoopAcc[i] = 0;
+            }
+            else
+            {
+                double curVel = (int32_t)(target - in.mPos[i]) * freq;
+                mImpl_->mLoopAcc[i] = (curVel - mImpl_->mLoopVel[i]) * freq;
+                mImpl_->mLoopVel[i] = curVel;
+            }
+
+            in.mPos[i] = target;
+            in.mVel[i] = (int32_t)mImpl_->mLoopVel[i];
+            in.mAcc[i] = (int32_t)mImpl_->mLoopAcc[i];
+            in.mTorque[i] = out.mTorque[i];
+        }
+    }
+
+    bool ServoBus::readVal(uint32_t index, int valIndex, double &value)
+    {
+        return false;
+    }
+
+    bool ServoBus::writeVal(uint32_t index, int valIndex, double value)
+    {
+        return false;
+    }
+
+    ServoValStat ServoBus::stepVal(uint32_t index, bool write, int valIndex, double &value, bool start)
+    {
+        bool ok = write ? writeVal(index, valIndex, value) : readVal(index, valIndex, value);
+        return ok ? ServoValStat::DONE : ServoValStat::ERROR;
+    }
+
+    void ServoBus::bindImage(void *inputMem, void *outputMem, bool keep)
+    {
+        uint32_t num = mImpl_->mSlaveNum;
+
+        if (inputMem)
+        {
+            if (keep)
+                memmove(inputMem, mImpl_->mInput.mTorque, inputImageSize(num));
+            mapInput(mImpl_->mInput, inputMem, num);
+        }
+
+        if (outputMem)
+        {
+            if (keep)
+                memmove(outputMem, mImpl_->mOutput.mTorque, outputImageSize(num));
+            mapOutput(mImpl_->mOutput, outputMem, num);
+        }
+    }
+
+    void ServoBus::unbindImage(bool keep)
+    {
+        void *inputMem = mImpl_->mInputMem.data();
+        void *outputMem = mImpl_->mOutputMem.data();
+        bindImage(inputMem != mImpl_->mInput.mTorque ? inputMem : nullptr,
+                  outputMem != mImpl_->mOutput.mTorque ? outputMem : nullptr, keep);
+    }
+
+} // namespace Uranus
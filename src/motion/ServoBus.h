@@ -0,0 +1,136 @@
+/*
+ * ServoBus.h
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#ifndef _URANUS_SERVOBUS_HPP_
+#define _URANUS_SERVOBUS_HPP_
+
+#include "Servo.h"
+
+namespace Uranus
+{
+
+// 控制字
+#define URANUS_SERVOBUS_CW_ENABLE 0x0001    // 使能
+#define URANUS_SERVOBUS_CW_RESET 0x0002     // 复位错误
+#define URANUS_SERVOBUS_CW_QUICKSTOP 0x0004 // 急停，轴复位错误时清除
+
+// 状态字
+#define URANUS_SERVOBUS_SW_ENABLED 0x0001 // 已使能
+#define URANUS_SERVOBUS_SW_FAULT 0x0002   // 故障，错误码见mErrorCode
+
+#pragma pack(push)
+#pragma pack(4)
+
+    enum class ServoBusMode : uint8_t
+    {
+        POSITION = 0,
+        VELOCITY = 1,
+        TORQUE = 2,
+    };
+
+    // 输入过程映像(站点->主站)，SoA，各数组按站号索引
+    struct ServoBusInput
+    {
+        int32_t *mPos = nullptr;
+        int32_t *mVel = nullptr;
+        int32_t *mAcc = nullptr;
+        double *mTorque = nullptr;
+        uint16_t *mStatusWord = nullptr;
+        MC_ServoErrorCode *mErrorCode = nullptr;
+    };
+
+    // 输出过程映像(主站->站点)
+    struct ServoBusOutput
+    {
+        int32_t *mPos = nullptr;
+        int32_t *mVel = nullptr;
+        double *mTorque = nullptr;
+        uint16_t *mControlWord = nullptr;
+        ServoBusMode *mMode = nullptr;
+    };
+
+    /*
+     * 批量过程映像伺服接口
+     * 各轴通过newServo得到的代理Servo只读写映像中自己的一列，
+     * Scheduler每周期所有轴执行完成后调用一次exchange，整体交换输入与输出映像
+     * 默认exchange为环回：目标位置直接作为实际位置，与Servo的理想积分器一致
+     */
+    class ServoBus
+    {
+    public:
+        explicit ServoBus(uint32_t slaveNum);
+        virtual ~ServoBus();
+
+        uint32_t slaveNum(void) const;
+
+        /*
+         * 为站点index创建代理Servo，交给Scheduler::newAxis，由轴负责释放
+         * 站号越界或已被占用时返回nullptr
+         */
+        Servo *newServo(uint32_t index);
+
+        const ServoBusInput &input(void) const;
+        const ServoBusOutput &output(void) const;
+
+        // 映像所需的连续内存大小
+        static size_t inputImageSize(uint32_t slaveNum);
+        static size_t outputImageSize(uint32_t slaveNum);
+
+        /*
+         * 交换过程映像，发送输出映像并读入最新的输入映像
+         * freq:调度周期频率
+         */
+        virtual void exchange(double freq);
+
+        // 非周期参数访问，默认不支持
+        virtual bool readVal(uint32_t index, int valIndex, double &value);
+        virtual bool writeVal(uint32_t index, int valIndex, double value);
+
+        /*
+         * 分步执行站点index的异步参数请求，含义同Servo::stepVal，默认同步调用readVal/writeVal
+         * 各轴分区并行执行时可能在多个线程中同时调用
+         */
+        virtual ServoValStat stepVal(uint32_t index, bool write, int valIndex, double &value, bool start);
+
+    protected:
+        /*
+         * 将映像重新映射到外部内存(如DMA区、共享内存)，大小见inputImageSize/outputImageSize
+         * keep:是否将当前映像内容拷贝到新内存
+         */
+        void bindImage(void *inputMem, void *outputMem, bool keep = true);
+
+        // 恢复使用内部映像
+        void unbindImage(bool keep = true);
+
+    private:
+        class ServoBusImpl;
+        ServoBusImpl *mImpl_;
+        friend class ServoBusSlave;
+    };
+
+#pragma pack(pop)
+
+}
+
+#endif /** _URANUS_SERVOBUS_HPP_ **/
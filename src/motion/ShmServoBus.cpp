@@ -0,0 +1,496 @@
+/*
+ * ShmServoBus.cpp
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "ShmServoBus.h"
+
+#include <atomic>
+#include <cstring>
+#include <string>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Uranus
+{
+
+#define URANUS_SHM_MAGIC 0x55534D49 // "USMI"
+#define URANUS_SHM_VERSION 1
+#define URANUS_SHM_BUFFER_NUM 3
+#define URANUS_SHM_INDEX_MASK 0x3
+#define URANUS_SHM_FRESH 0x4 // 最新缓冲区尚未被读方取走
+#define URANUS_SHM_ALIGN 64
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared memory image requires lock-free atomics");
+
+    // 单向通道，三缓冲区分别由写方、读方和"最新"持有
+    struct ShmChannel
+    {
+        std::atomic<uint32_t> mLatest;
+        std::atomic<uint32_t> mSeq;
+        uint32_t mWriterIndex; // 只由写方修改
+        uint32_t mReaderIndex; // 只由读方修改
+        uint32_t mBufferSeq[URANUS_SHM_BUFFER_NUM];
+        uint32_t mReserved;
+    };
+
+    struct ShmHeader
+    {
+        std::atomic<uint32_t> mMagic;
+        uint32_t mVersion;
+        uint32_t mSlaveNum;
+        uint32_t mReserved;
+        uint64_t mInputSize;  // 单个输入缓冲区大小
+        uint64_t mOutputSize; // 单个输出缓冲区大小
+        ShmChannel mInput;    // 主站写，运动核心读
+        ShmChannel mOutput;   // 运动核心写，主站读
+    };
+
+    static inline size_t alignShm(size_t size)
+    {
+        return (size + URANUS_SHM_ALIGN - 1) & ~(size_t)(URANUS_SHM_ALIGN - 1);
+    }
+
+    // 发布写方缓冲区，返回新的写方缓冲区
+    static uint32_t publishChannel(ShmChannel &ch)
+    {
+        uint32_t back = ch.mWriterIndex;
+        uint32_t seq = ch.mSeq.load(std::memory_order_relaxed) + 1;
+        ch.mBufferSeq[back] = seq;
+
+        uint32_t old = ch.mLatest.exchange(back | URANUS_SHM_FRESH, std::memory_order_acq_rel);
+        ch.mSeq.store(seq, std::memory_order_release);
+        ch.mWriterIndex = old & URANUS_SHM_INDEX_MASK;
+        return ch.mWriterIndex;
+    }
+
+    // 有新数据时取走最新缓冲区
+    static bool acquireChannel(ShmChannel &ch)
+    {
+        if (!(ch.mLatest.load(std::memory_order_acquire) & URANUS_SHM_FRESH))
+            return false;
+
+        uint32_t old = ch.mLatest.exchange(ch.mReaderIndex, std::memory_order_acq_rel);
+        ch.mReaderIndex = old & URANUS_SHM_INDEX_MASK;
+        return true;
+    }
+
+    // 跨平台的命名共享内存
+    class ShmRegion
+    {
+    public:
+        void *mBase = nullptr;
+        size_t mSize = 0;
+        std::string mName;
+        bool mOwner = false;
+#if defined(_WIN32)
+        HANDLE mHandle = nullptr;
+#endif
+
+    public:
+        ~ShmRegion() { close(); }
+
+        bool create(const char *name, size_t size);
+        bool attach(const char *name);
+        void close(void);
+
+        ShmHeader *header(void) const { return (ShmHeader *)mBase; }
+        uint8_t *inputBuffer(uint32_t index) const;
+        uint8_t *outputBuffer(uint32_t index) const;
+
+        static size_t regionSize(uint32_t slaveNum);
+
+    private:
+        void setName(const char *name);
+    };
+
+    size_t ShmRegion::regionSize(uint32_t slaveNum)
+    {
+        return alignShm(sizeof(ShmHeader)) +
+               alignShm(ServoBus::inputImageSize(slaveNum)) * URANUS_SHM_BUFFER_NUM +
+               alignShm(ServoBus::outputImageSize(slaveNum)) * URANUS_SHM_BUFFER_NUM;
+    }
+
+    uint8_t *ShmRegion::inputBuffer(uint32_t index) const
+    {
+        return (uint8_t *)mBase + alignShm(sizeof(ShmHeader)) + header()->mInputSize * index;
+    }
+
+    uint8_t *ShmRegion::outputBuffer(uint32_t index) const
+    {
+        return inputBuffer(URANUS_SHM_BUFFER_NUM) + header()->mOutputSize * index;
+    }
+
+    void ShmRegion::setName(const char *name)
+    {
+#if defined(_WIN32)
+        mName = name;
+#else
+        mName = (name[0] == '/') ? name : std::string("/") + name;
+#endif
+    }
+
+    bool ShmRegion::create(const char *name, size_t size)
+    {
+        close();
+        setName(name);
+
+#if defined(_WIN32)
+        mHandle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                     (DWORD)((uint64_t)size >> 32), (DWORD)size, mName.c_str());
+        if (!mHandle)
+            return false;
+
+        mBase = MapViewOfFile(mHandle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (!mBase)
+        {
+            CloseHandle(mHandle);
+            mHandle = nullptr;
+            return false;
+        }
+#else
+        int fd = shm_open(mName.c_str(), O_CREAT | O_RDWR, 0660);
+        if (fd < 0)
+            return false;
+
+        if (ftruncate(fd, (off_t)size) != 0)
+        {
+            ::close(fd);
+            shm_unlink(mName.c_str());
+            return false;
+        }
+
+        mBase = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (MAP_FAILED == mBase)
+        {
+            mBase = nullptr;
+            shm_unlink(mName.c_str());
+            return false;
+        }
+#endif
+
+        mSize = size;
+        mOwner = true;
+        return true;
+    }
+
+    bool ShmRegion::attach(const char *name)
+    {
+        close();
+        setName(name);
+
+#if defined(_WIN32)
+        mHandle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, mName.c_str());
+        if (!mHandle)
+            return false;
+
+        mBase = MapViewOfFile(mHandle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        if (!mBase)
+        {
+            CloseHandle(mHandle);
+            mHandle = nullptr;
+            return false;
+        }
+
+        MEMORY_BASIC_INFORMATION info;
+        VirtualQuery(mBase, &info, sizeof(info));
+        mSize = info.RegionSize;
+#else
+        int fd = shm_open(mName.c_str(), O_RDWR, 0);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ShmHeader))
+        {
+            ::close(fd);
+            return false;
+        }
+
+        mBase = mmap(nullptr, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (MAP_FAILED == mBase)
+        {
+            mBase = nullptr;
+            return false;
+        }
+
+        mSize = (size_t)st.st_size;
+#endif
+
+        mOwner = false;
+        return true;
+    }
+
+    void ShmRegion::close(void)
+    {
+        if (!mBase)
+            return;
+
+#if defined(_WIN32)
+        UnmapViewOfFile(mBase);
+        CloseHandle(mHandle);
+        mHandle = nullptr;
+#else
+        munmap(mBase, mSize);
+        if (mOwner)
+            shm_unlink(mName.c_str());
+#endif
+
+        mBase = nullptr;
+        mSize = 0;
+        mOwner = false;
+    }
+
+    /////////////////////////////////////////////////////////////
+
+    class ShmServoBus::ShmServoBusImpl
+    {
+    public:
+        ShmRegion mRegion;
+        uint32_t mInputSeq = 0;
+        uint32_t mStaleCycles = 0;
+    };
+
+    ShmServoBus::ShmServoBus(uint32_t slaveNum) : ServoBus(slaveNum)
+    {
+        mImpl_ = new ShmServoBusImpl();
+    }
+
+    ShmServoBus::~ShmServoBus()
+    {
+        close();
+        delete mImpl_;
+    }
+
+    MC_ErrorCode ShmServoBus::open(const char *name)
+    {
+        if (!name || !name[0])
+            return MC_ErrorCode::CFG_SHM_OPEN_FAILED;
+
+        close();
+
+        ShmRegion &region = mImpl_->mRegion;
+        if (!region.create(name, ShmRegion::regionSize(slaveNum())))
+            return MC_ErrorCode::CFG_SHM_OPEN_FAILED;
+
+        memset(region.mBase, 0, region.mSize);
+
+        ShmHeader *hdr = region.header();
+        hdr->mVersion = URANUS_SHM_VERSION;
+        hdr->mSlaveNum = slaveNum();
+        hdr->mInputSize = alignShm(inputImageSize(slaveNum()));
+        hdr->mOutputSize = alignShm(outputImageSize(slaveNum()));
+
+        for (ShmChannel *ch : {&hdr->mInput, &hdr->mOutput})
+        {
+            ch->mWriterIndex = 0;
+            ch->mLatest.store(1, std::memory_order_relaxed);
+            ch->mReaderIndex = 2;
+        }
+
+        // 当前映像内容作为初始值
+        uint32_t front = hdr->mInput.mReaderIndex;
+        uint32_t back = hdr->mOutput.mWriterIndex;
+        bindImage(region.inputBuffer(front), region.outputBuffer(back));
+        for (uint32_t i = 0; i < URANUS_SHM_BUFFER_NUM; ++i)
+        {
+            if (i != front)
+                memcpy(region.inputBuffer(i), input().mTorque, inputImageSize(slaveNum()));
+            if (i != back)
+                memcpy(region.outputBuffer(i), output().mTorque, outputImageSize(slaveNum()));
+        }
+
+        mImpl_->mInputSeq = 0;
+        mImpl_->mStaleCycles = 0;
+        hdr->mMagic.store(URANUS_SHM_MAGIC, std::memory_order_release);
+
+        return MC_ErrorCode::GOOD;
+    }
+
+    void ShmServoBus::close(void)
+    {
+        if (!isOpen())
+            return;
+
+        unbindImage();
+        mImpl_->mRegion.header()->mMagic.store(0, std::memory_order_release);
+        mImpl_->mRegion.close();
+    }
+
+    bool ShmServoBus::isOpen(void) const
+    {
+        return mImpl_->mRegion.mBase != nullptr;
+    }
+
+    uint32_t ShmServoBus::inputSequence(void) const
+    {
+        return mImpl_->mInputSeq;
+    }
+
+    uint32_t ShmServoBus::staleCycles(void) const
+    {
+        return mImpl_->mStaleCycles;
+    }
+
+    void ShmServoBus::exchange(double freq)
+    {
+        if (!isOpen())
+        {
+            ServoBus::exchange(freq);
+            return;
+        }
+
+        ShmRegion &region = mImpl_->mRegion;
+        ShmHeader *hdr = region.header();
+
+        // 发布本周期的输出，新的后台缓冲区从已发布的内容继续
+        uint32_t back = publishChannel(hdr->mOutput);
+        bindImage(nullptr, region.outputBuffer(back));
+
+        // 切换到主站最新发布的输入
+        if (acquireChannel(hdr->mInput))
+        {
+            uint32_t front = hdr->mInput.mReaderIndex;
+            mImpl_->mInputSeq = hdr->mInput.mBufferSeq[front];
+            mImpl_->mStaleCycles = 0;
+            bindImage(region.inputBuffer(front), nullptr, false);
+        }
+        else
+        {
+            ++mImpl_->mStaleCycles;
+        }
+    }
+
+    /////////////////////////////////////////////////////////////
+
+    class ShmServoMaster::ShmServoMasterImpl
+    {
+    public:
+        ShmRegion mRegion;
+        ServoBus *mPlant = nullptr; // 驱动器模型
+        uint32_t mOutputSeq = 0;
+    };
+
+    ShmServoMaster::ShmServoMaster()
+    {
+        mImpl_ = new ShmServoMasterImpl();
+    }
+
+    ShmServoMaster::~ShmServoMaster()
+    {
+        close();
+        delete mImpl_;
+    }
+
+    MC_ErrorCode ShmServoMaster::open(const char *name)
+    {
+        if (!name || !name[0])
+            return MC_ErrorCode::CFG_SHM_OPEN_FAILED;
+
+        close();
+
+        ShmRegion &region = mImpl_->mRegion;
+        if (!region.attach(name))
+            return MC_ErrorCode::CFG_SHM_OPEN_FAILED;
+
+        ShmHeader *hdr = region.header();
+        if (URANUS_SHM_MAGIC != hdr->mMagic.load(std::memory_order_acquire) ||
+            URANUS_SHM_VERSION != hdr->mVersion ||
+            region.mSize < ShmRegion::regionSize(hdr->mSlaveNum))
+        {
+            region.close();
+            return MC_ErrorCode::CFG_SHM_LAYOUT_ILLEGAL;
+        }
+
+        uint32_t num = hdr->mSlaveNum;
+        mImpl_->mPlant = new ServoBus(num);
+
+        // 驱动器模型从当前的输入、输出映像继续，输入缓冲区只由主站写入
+        uint32_t latest = hdr->mInput.mLatest.load(std::memory_order_acquire) & URANUS_SHM_INDEX_MASK;
+        uint32_t front = hdr->mOutput.mReaderIndex;
+        memcpy(mImpl_->mPlant->input().mTorque, region.inputBuffer(latest), ServoBus::inputImageSize(num));
+        memcpy(mImpl_->mPlant->output().mTorque, region.outputBuffer(front), ServoBus::outputImageSize(num));
+        mImpl_->mOutputSeq = hdr->mOutput.mBufferSeq[front];
+
+        return MC_ErrorCode::GOOD;
+    }
+
+    void ShmServoMaster::close(void)
+    {
+        mImpl_->mRegion.close();
+        delete mImpl_->mPlant;
+        mImpl_->mPlant = nullptr;
+    }
+
+    bool ShmServoMaster::isOpen(void) const
+    {
+        return mImpl_->mPlant != nullptr;
+    }
+
+    uint32_t ShmServoMaster::slaveNum(void) const
+    {
+        return isOpen() ? mImpl_->mPlant->slaveNum() : 0;
+    }
+
+    uint32_t ShmServoMaster::outputSequence(void) const
+    {
+        return mImpl_->mOutputSeq;
+    }
+
+    bool ShmServoMaster::runCycle(double freq)
+    {
+        if (!isOpen())
+            return false;
+
+        ShmRegion &region = mImpl_->mRegion;
+        ShmHeader *hdr = region.header();
+        ServoBus *plant = mImpl_->mPlant;
+        uint32_t num = plant->slaveNum();
+
+        // 运动核心已关闭映像
+        if (URANUS_SHM_MAGIC != hdr->mMagic.load(std::memory_order_acquire))
+            return false;
+
+        if (acquireChannel(hdr->mOutput))
+        {
+            uint32_t front = hdr->mOutput.mReaderIndex;
+            mImpl_->mOutputSeq = hdr->mOutput.mBufferSeq[front];
+            memcpy(plant->output().mTorque, region.outputBuffer(front), ServoBus::outputImageSize(num));
+        }
+
+        plant->exchange(freq);
+
+        memcpy(region.inputBuffer(hdr->mInput.mWriterIndex), plant->input().mTorque, ServoBus::inputImageSize(num));
+        publishChannel(hdr->mInput);
+        return true;
+    }
+
+} // namespace Uranus
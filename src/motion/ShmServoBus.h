@@ -0,0 +1,110 @@
+/*
+ * ShmServoBus.h
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#ifndef _URANUS_SHMSERVOBUS_HPP_
+#define _URANUS_SHMSERVOBUS_HPP_
+
+#include "ServoBus.h"
+
+namespace Uranus
+{
+
+#pragma pack(push)
+#pragma pack(4)
+
+    /*
+     * 共享内存过程映像，供独立进程中的总线主站访问
+     * 输入、输出映像在共享内存中各有三个缓冲区，写方写入自己的后台缓冲区后与"最新"缓冲区交换并递增序号，
+     * 读方只在有新数据时与"最新"缓冲区交换，双方始终原位读写，不拷贝也不等待对方
+     * 代理Servo直接读写共享内存中的缓冲区，exchange时发布输出并切换到最新的输入
+     */
+    class ShmServoBus : public ServoBus
+    {
+    public:
+        explicit ShmServoBus(uint32_t slaveNum);
+        virtual ~ShmServoBus();
+
+        /*
+         * 创建并映射共享内存，已存在的同名映像被重新初始化
+         * name:映像名，POSIX下为shm_open的名字(可省略开头的'/')，Windows下为文件映射名
+         */
+        MC_ErrorCode open(const char *name);
+
+        // 解除映射并删除映像
+        void close(void);
+
+        bool isOpen(void) const;
+
+        // 最近一次读入的输入映像序号
+        uint32_t inputSequence(void) const;
+
+        // 连续未收到新输入的交换次数，可用于检测主站掉线
+        uint32_t staleCycles(void) const;
+
+        void exchange(double freq) override;
+
+    private:
+        class ShmServoBusImpl;
+        ShmServoBusImpl *mImpl_;
+    };
+
+    /*
+     * 用于测试的替身主站，映射ShmServoBus创建的映像，
+     * 以ServoBus的环回模型代替实际驱动器
+     */
+    class ShmServoMaster
+    {
+    public:
+        ShmServoMaster();
+        virtual ~ShmServoMaster();
+
+        // 映射已创建的映像，站数由映像决定
+        MC_ErrorCode open(const char *name);
+
+        void close(void);
+
+        bool isOpen(void) const;
+
+        uint32_t slaveNum(void) const;
+
+        // 最近一次读入的输出映像序号
+        uint32_t outputSequence(void) const;
+
+        /*
+         * 执行一个总线周期：读取最新的输出映像，驱动器模型执行一个周期，发布输入映像
+         * freq:总线周期频率
+         * 返回:false表示未打开或运动核心已关闭映像
+         */
+        bool runCycle(double freq);
+
+    private:
+        class ShmServoMasterImpl;
+        ShmServoMasterImpl *mImpl_;
+    };
+
+#pragma pack(pop)
+
+}
+
+#endif /** _URANUS_SHMSERVOBUS_HPP_ **/
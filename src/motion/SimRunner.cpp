@@ -0,0 +1,243 @@
+/*
+ * SimRunner.cpp
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "SimRunner.h"
+#include "Scheduler.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace Uranus
+{
+
+    class SimRunner::SimRunnerImpl
+    {
+    public:
+        struct CallbackItem
+        {
+            Callback mCallback;
+            void *mCtx;
+        };
+
+        struct Instance
+        {
+            Scheduler *mSched = nullptr;
+            std::vector<CallbackItem> mCallbacks;
+            double mFrequency = 0;
+            uint64_t mCycleLimit = 0; // 0为不限
+            std::atomic<uint64_t> mCycles{0};
+        };
+
+        std::vector<std::unique_ptr<Instance>> mInstances;
+        uint32_t mThreadNum = 0;
+
+        std::atomic<uint32_t> mNext{0};
+        std::atomic<bool> mRunning{false};
+        std::atomic<bool> mExit{false};
+        SimStatistics mStat;
+
+    public:
+        static void task(void *ctx, uint32_t index);
+        void runInstance(Instance &inst);
+    };
+
+    void SimRunner::SimRunnerImpl::task(void *ctx, uint32_t index)
+    {
+        (void)index;
+        SimRunnerImpl *impl = static_cast<SimRunnerImpl *>(ctx);
+
+        // 动态领取实例，耗时不同的实例间自动均衡
+        uint32_t i;
+        while ((i = impl->mNext.fetch_add(1, std::memory_order_relaxed)) < impl->mInstances.size())
+            impl->runInstance(*impl->mInstances[i]);
+    }
+
+    void SimRunner::SimRunnerImpl::runInstance(Instance &inst)
+    {
+        Scheduler *sched = inst.mSched;
+        uint64_t cycles = 0;
+
+        while (!mExit.load(std::memory_order_relaxed) && (!inst.mCycleLimit || cycles < inst.mCycleLimit))
+        {
+            sched->runCycle();
+            inst.mCycles.store(++cycles, std::memory_order_relaxed);
+
+            bool keep = true;
+            for (auto &item : inst.mCallbacks)
+                keep = item.mCallback(item.mCtx) && keep;
+            if (!keep)
+                break;
+        }
+    }
+
+    SimRunner::SimRunner()
+    {
+        mImpl_ = new SimRunnerImpl();
+    }
+
+    SimRunner::~SimRunner()
+    {
+        delete mImpl_;
+    }
+
+    MC_ErrorCode SimRunner::addScheduler(Scheduler *sched, uint32_t &instance)
+    {
+        if (!sched)
+            return MC_ErrorCode::PARAMETER_NOT_SUPPORT;
+
+        if (isRunning())
+            return MC_ErrorCode::AXIS_BUSY;
+
+        instance = mImpl_->mInstances.size();
+        mImpl_->mInstances.emplace_back(new SimRunnerImpl::Instance());
+        mImpl_->mInstances.back()->mSched = sched;
+        return MC_ErrorCode::GOOD;
+    }
+
+    MC_ErrorCode SimRunner::addCallback(uint32_t instance, Callback callback, void *ctx)
+    {
+        if (!callback || instance >= mImpl_->mInstances.size())
+            return MC_ErrorCode::PARAMETER_NOT_SUPPORT;
+
+        if (isRunning())
+            return MC_ErrorCode::AXIS_BUSY;
+
+        mImpl_->mInstances[instance]->mCallbacks.push_back({callback, ctx});
+        return MC_ErrorCode::GOOD;
+    }
+
+    MC_ErrorCode SimRunner::setThreadNum(uint32_t threadNum)
+    {
+        if (isRunning())
+            return MC_ErrorCode::AXIS_BUSY;
+
+        mImpl_->mThreadNum = threadNum;
+        return MC_ErrorCode::GOOD;
+    }
+
+    MC_ErrorCode SimRunner::run(double duration)
+    {
+        if (mImpl_->mInstances.empty() || !(duration >= 0))
+            return MC_ErrorCode::PARAMETER_NOT_SUPPORT;
+
+        if (mImpl_->mRunning.exchange(true))
+            return MC_ErrorCode::AXIS_BUSY;
+
+        // 所有实例按同一仿真时长运行，周期数由各自频率换算
+        for (auto &inst : mImpl_->mInstances)
+        {
+            inst->mFrequency = inst->mSched->frequency();
+            inst->mCycleLimit = (uint64_t)std::llround(duration * inst->mFrequency);
+            inst->mCycles.store(0, std::memory_order_relaxed);
+        }
+
+        uint32_t threadNum = mImpl_->mThreadNum;
+        if (!threadNum)
+            threadNum = std::max(std::thread::hardware_concurrency(), 1U);
+        threadNum = std::min<uint32_t>(threadNum, mImpl_->mInstances.size());
+
+        mImpl_->mNext.store(0, std::memory_order_relaxed);
+        mImpl_->mExit.store(false, std::memory_order_release);
+
+        auto start = std::chrono::steady_clock::now();
+        if (threadNum > 1)
+        {
+            WorkerPool pool;
+            pool.start(threadNum, &SimRunnerImpl::task, mImpl_);
+            pool.run();
+        }
+        else
+        {
+            SimRunnerImpl::task(mImpl_, 0);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        SimStatistics &stat = mImpl_->mStat;
+        stat = SimStatistics();
+        stat.mInstances = mImpl_->mInstances.size();
+        stat.mThreads = threadNum;
+        stat.mWallTime = std::chrono::duration<double>(end - start).count();
+        for (auto &inst : mImpl_->mInstances)
+        {
+            uint64_t cycles = inst->mCycles.load(std::memory_order_relaxed);
+            stat.mCycles += cycles;
+            stat.mSimTime += cycles / inst->mFrequency;
+        }
+        if (stat.mWallTime > 0)
+        {
+            stat.mCyclesPerSecond = stat.mCycles / stat.mWallTime;
+            stat.mRealtimeFactor = stat.mSimTime / stat.mWallTime;
+        }
+
+        mImpl_->mRunning.store(false, std::memory_order_release);
+        return MC_ErrorCode::GOOD;
+    }
+
+    void SimRunner::stop(void)
+    {
+        mImpl_->mExit.store(true, std::memory_order_release);
+    }
+
+    bool SimRunner::isRunning(void) const
+    {
+        return mImpl_->mRunning.load(std::memory_order_acquire);
+    }
+
+    uint32_t SimRunner::instanceNum(void) const
+    {
+        return mImpl_->mInstances.size();
+    }
+
+    uint64_t SimRunner::cycles(uint32_t instance) const
+    {
+        if (instance >= mImpl_->mInstances.size())
+            return 0;
+
+        return mImpl_->mInstances[instance]->mCycles.load(std::memory_order_relaxed);
+    }
+
+    double SimRunner::simTime(uint32_t instance) const
+    {
+        if (instance >= mImpl_->mInstances.size())
+            return 0;
+
+        const SimRunnerImpl::Instance &inst = *mImpl_->mInstances[instance];
+        if (inst.mFrequency <= 0)
+            return 0;
+
+        return inst.mCycles.load(std::memory_order_relaxed) / inst.mFrequency;
+    }
+
+    void SimRunner::readStatistics(SimStatistics &stat) const
+    {
+        stat = mImpl_->mStat;
+    }
+
+} // namespace Uranus
@@ -0,0 +1,106 @@
+/*
+ * SimRunner.h
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#ifndef _URANUS_SIMRUNNER_HPP_
+#define _URANUS_SIMRUNNER_HPP_
+
+#include "Global.h"
+
+namespace Uranus
+{
+
+#pragma pack(push)
+#pragma pack(4)
+
+    class Scheduler;
+
+    /*
+     * 仿真周期驱动，以虚拟时钟代替CycleRunner的绝对截止时间：
+     * 每个调度器实例背靠背地执行Scheduler::runCycle及其回调，不等待，
+     * 实例的仿真时间为已执行周期数/调度频率。
+     * 各实例相互独立，由多个线程并行执行，每个实例始终只在一个线程中运行，
+     * 因此同一实例的结果与线程数无关
+     */
+    class SimRunner
+    {
+    public:
+        // 周期回调，返回false时该实例停止运行
+        typedef bool (*Callback)(void *ctx);
+
+        SimRunner();
+
+        virtual ~SimRunner();
+
+        // 添加调度器实例，instance返回实例号；运行中不可修改
+        MC_ErrorCode addScheduler(Scheduler *sched, uint32_t &instance);
+
+        // 为实例注册周期回调，运行中不可修改
+        MC_ErrorCode addCallback(uint32_t instance, Callback callback, void *ctx);
+
+        // 注册可调用对象，对象须在运行期间有效
+        template <typename F>
+        MC_ErrorCode addCallback(uint32_t instance, F &func)
+        {
+            return addCallback(instance,
+                               [](void *ctx) -> bool
+                               { return (*static_cast<F *>(ctx))(); },
+                               &func);
+        }
+
+        // 设定并行线程数(包含调用run()的线程)，0为CPU核数，超过实例数时按实例数
+        MC_ErrorCode setThreadNum(uint32_t threadNum);
+
+        /*
+         * 在当前线程及工作线程中运行所有实例，直到各实例仿真时间达到duration(s)、
+         * 回调返回false或调用stop()；duration为0时不限时长。
+         * 运行期间不可修改调度器频率
+         */
+        MC_ErrorCode run(double duration);
+
+        // 停止运行，可在回调或其他线程中调用
+        void stop(void);
+
+        bool isRunning(void) const;
+
+        uint32_t instanceNum(void) const;
+
+        // 实例已执行的周期数，运行中可读取
+        uint64_t cycles(uint32_t instance) const;
+
+        // 实例的仿真时间(s)，即虚拟时钟
+        double simTime(uint32_t instance) const;
+
+        // 读取最近一次run()的统计
+        void readStatistics(SimStatistics &stat) const;
+
+    private:
+        class SimRunnerImpl;
+        SimRunnerImpl *mImpl_;
+    };
+
+#pragma pack(pop)
+
+}
+
+#endif /** _URANUS_SIMRUNNER_HPP_ **/
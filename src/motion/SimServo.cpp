@@ -0,0 +1,413 @@
+/*
+ * SimServo.cpp
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "SimServo.h"
+
+#include <cmath>
+#include <vector>
+
+namespace Uranus
+{
+
+// 指令延迟的最大周期数
+#define URANUS_SIMSERVO_MAX_BUS_DELAY 1024
+#define URANUS_SIMSERVO_2PI 6.283185307179586
+
+    struct SimServoCommand
+    {
+        MC_ServoControlMode mMode = MC_ServoControlMode::POSITION;
+        int32_t mPos = 0;
+        int32_t mVel = 0;
+        double mTorque = 0;
+    };
+
+    class SimServo::SimServoImpl
+    {
+    public:
+        SimServoConfig mConfig;
+        double mCountsPerRad = 0;
+        double mRadPerCount = 0;
+        double mInvInertia = 0;
+        double mTorqueLimit = 0;
+
+        // 指令延迟队列
+        SimServoCommand mSubmit;
+        std::vector<SimServoCommand> mRing;
+        size_t mRingPos = 0;
+
+        // 负载状态(rad)
+        double mPos = 0;
+        double mVel = 0;
+        double mLoadTorque = 0;
+        double mMotorTorque = 0;
+
+        // 驱动器状态
+        bool mPowered = false;
+        bool mQuickStop = false;
+        double mIntegral = 0;
+        double mTarget = 0;    // 展开后的目标位置(计数)
+        int32_t mTargetRaw = 0; // 上周期收到的目标位置
+
+        // 反馈
+        int32_t mFbPos = 0;
+        double mFbVel = 0;
+        double mFbAcc = 0;
+
+    public:
+        void applyConfig(void);
+        void holdPosition(void);
+        double velocityLoop(double velRef, double dt);
+        void integrate(double motorTorque, double dt);
+        int32_t encoder(void) const;
+    };
+
+    void SimServo::SimServoImpl::applyConfig(void)
+    {
+        mCountsPerRad = mConfig.mCountsPerRev / URANUS_SIMSERVO_2PI;
+        mRadPerCount = 1 / mCountsPerRad;
+        mInvInertia = 1 / mConfig.mInertia;
+        mTorqueLimit = mConfig.mTorqueConstant * mConfig.mMaxCurrent;
+        mRing.assign(mConfig.mBusDelay + 1, mSubmit);
+        mRingPos = 0;
+    }
+
+    // 周期内每个子步都要取整，避免调用libm的floor
+    static inline double floorCounts(double x)
+    {
+        double t = (double)(int64_t)x;
+        return t > x ? t - 1 : t;
+    }
+
+    inline int32_t SimServo::SimServoImpl::encoder(void) const
+    {
+        // 与AxisBase::toDevRaw一致，超出32位时回绕
+        return (int32_t)(int64_t)floorCounts(mPos * mCountsPerRad);
+    }
+
+    void SimServo::SimServoImpl::holdPosition(void)
+    {
+        mSubmit.mMode = MC_ServoControlMode::POSITION;
+        mSubmit.mPos = encoder();
+        mRing.assign(mRing.size(), mSubmit);
+        mTargetRaw = mSubmit.mPos;
+        mTarget = floorCounts(mPos * mCountsPerRad);
+        mIntegral = 0;
+    }
+
+    double SimServo::SimServoImpl::velocityLoop(double velRef, double dt)
+    {
+        double err = velRef - mVel;
+        double torque = mConfig.mVelKp * err + mConfig.mVelKi * (mIntegral + err * dt);
+
+        // 饱和时停止积分
+        if (fabs(torque) < mTorqueLimit)
+            mIntegral += err * dt;
+
+        return fmax(-mTorqueLimit, fmin(mTorqueLimit, torque));
+    }
+
+    void SimServo::SimServoImpl::integrate(double motorTorque, double dt)
+    {
+        double drive = motorTorque + mLoadTorque;
+        double coulomb = mConfig.mCoulombFriction;
+        double net;
+
+        if (0 == mVel)
+        { // 静摩擦
+            if (fabs(drive) <= coulomb)
+                return;
+            net = drive - copysign(coulomb, drive);
+        }
+        else
+        {
+            net = drive - copysign(coulomb, mVel) - mConfig.mViscousFriction * mVel;
+        }
+
+        double vel = mVel + net * mInvInertia * dt;
+
+        // 摩擦不能使速度反向，过零时停在零速
+        if (0 != mVel && (vel > 0) != (mVel > 0))
+            vel = 0;
+
+        mPos += (mVel + vel) * 0.5 * dt;
+        mVel = vel;
+    }
+
+    /////////////////////////////////////////////////////////////
+
+    SimServo::SimServo()
+    {
+        mImpl_ = new SimServoImpl();
+        mImpl_->applyConfig();
+    }
+
+    SimServo::SimServo(const SimServoConfig &config)
+    {
+        mImpl_ = new SimServoImpl();
+        if (!setConfig(config))
+            mImpl_->applyConfig();
+    }
+
+    SimServo::~SimServo()
+    {
+        delete mImpl_;
+    }
+
+    bool SimServo::setConfig(const SimServoConfig &config)
+    {
+        if (!config.mCountsPerRev || !config.mSubsteps || config.mBusDelay > URANUS_SIMSERVO_MAX_BUS_DELAY ||
+            !(config.mInertia > 0) || config.mMaxCurrent < 0 || config.mTorqueConstant < 0 ||
+            config.mCoulombFriction < 0 || config.mViscousFriction < 0)
+            return false;
+
+        mImpl_->mConfig = config;
+        mImpl_->applyConfig();
+        return true;
+    }
+
+    const SimServoConfig &SimServo::config(void) const
+    {
+        return mImpl_->mConfig;
+    }
+
+    void SimServo::setLoadTorque(double torque)
+    {
+        mImpl_->mLoadTorque = torque;
+    }
+
+    void SimServo::reset(int32_t pos)
+    {
+        mImpl_->mPos = pos / mImpl_->mCountsPerRad;
+        mImpl_->mVel = 0;
+        mImpl_->mMotorTorque = 0;
+        mImpl_->mFbPos = mImpl_->encoder();
+        mImpl_->mFbVel = mImpl_->mFbAcc = 0;
+        mImpl_->holdPosition();
+    }
+
+    MC_ServoErrorCode SimServo::setPower(bool powerStatus, bool &isDone)
+    {
+        if (powerStatus && !mImpl_->mPowered)
+        { // 使能时保持当前位置
+            mImpl_->holdPosition();
+            mImpl_->mQuickStop = false;
+        }
+
+        mImpl_->mPowered = powerStatus;
+        isDone = true;
+        return 0;
+    }
+
+    MC_ServoErrorCode SimServo::setPos(int32_t pos)
+    {
+        mImpl_->mSubmit.mMode = MC_ServoControlMode::POSITION;
+        mImpl_->mSubmit.mPos = pos;
+        return 0;
+    }
+
+    MC_ServoErrorCode SimServo::setVel(int32_t vel)
+    {
+        mImpl_->mSubmit.mMode = MC_ServoControlMode::VELOCITY;
+        mImpl_->mSubmit.mVel = vel;
+        return 0;
+    }
+
+    MC_ServoErrorCode SimServo::setTorque(double torque)
+    {
+        mImpl_->mSubmit.mMode = MC_ServoControlMode::TORQUE;
+        mImpl_->mSubmit.mTorque = torque;
+        return 0;
+    }
+
+    int32_t SimServo::pos(void)
+    {
+        return mImpl_->mFbPos;
+    }
+
+    int32_t SimServo::vel(void)
+    {
+        return (int32_t)mImpl_->mFbVel;
+    }
+
+    int32_t SimServo::acc(void)
+    {
+        return (int32_t)mImpl_->mFbAcc;
+    }
+
+    double SimServo::torque(void)
+    {
+        return mImpl_->mMotorTorque;
+    }
+
+    bool SimServo::readVal(int index, double &value)
+    {
+        const SimServoConfig &cfg = mImpl_->mConfig;
+        switch (index)
+        {
+        case URANUS_SIMSERVO_VAL_POS_KP:
+            value = cfg.mPosKp;
+            return true;
+        case URANUS_SIMSERVO_VAL_VEL_KP:
+            value = cfg.mVelKp;
+            return true;
+        case URANUS_SIMSERVO_VAL_VEL_KI:
+            value = cfg.mVelKi;
+            return true;
+        case URANUS_SIMSERVO_VAL_VEL_FF:
+            value = cfg.mVelFF;
+            return true;
+        case URANUS_SIMSERVO_VAL_INERTIA:
+            value = cfg.mInertia;
+            return true;
+        case URANUS_SIMSERVO_VAL_LOAD_TORQUE:
+            value = mImpl_->mLoadTorque;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool SimServo::writeVal(int index, double value)
+    {
+        SimServoConfig &cfg = mImpl_->mConfig;
+        if (!std::isfinite(value))
+            return false;
+
+        switch (index)
+        {
+        case URANUS_SIMSERVO_VAL_POS_KP:
+            cfg.mPosKp = value;
+            return true;
+        case URANUS_SIMSERVO_VAL_VEL_KP:
+            cfg.mVelKp = value;
+            return true;
+        case URANUS_SIMSERVO_VAL_VEL_KI:
+            cfg.mVelKi = value;
+            return true;
+        case URANUS_SIMSERVO_VAL_VEL_FF:
+            cfg.mVelFF = value;
+            return true;
+        case URANUS_SIMSERVO_VAL_INERTIA:
+            if (value <= 0)
+                return false;
+            cfg.mInertia = value;
+            mImpl_->mInvInertia = 1 / value;
+            return true;
+        case URANUS_SIMSERVO_VAL_LOAD_TORQUE:
+            mImpl_->mLoadTorque = value;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    MC_ServoErrorCode SimServo::resetError(bool &isDone)
+    {
+        mImpl_->mQuickStop = false;
+        isDone = true;
+        return 0;
+    }
+
+    void SimServo::runCycle(double freq)
+    {
+        SimServoImpl *impl = mImpl_;
+        const SimServoConfig &cfg = impl->mConfig;
+
+        // 指令经过mBusDelay个周期到达驱动器
+        impl->mRing[impl->mRingPos] = impl->mSubmit;
+        if (++impl->mRingPos == impl->mRing.size())
+            impl->mRingPos = 0;
+        const SimServoCommand &cmd = impl->mRing[impl->mRingPos];
+
+        // 目标位置按32位回绕展开
+        double targetPrev = impl->mTarget;
+        if (MC_ServoControlMode::POSITION == cmd.mMode)
+        {
+            impl->mTarget += (int32_t)((uint32_t)cmd.mPos - (uint32_t)impl->mTargetRaw);
+            impl->mTargetRaw = cmd.mPos;
+        }
+        else
+        {
+            impl->mTarget = floorCounts(impl->mPos * impl->mCountsPerRad);
+            impl->mTargetRaw = impl->encoder();
+        }
+
+        uint32_t steps = cfg.mSubsteps;
+        double dt = 1.0 / (freq * steps);
+        double step = (impl->mTarget - targetPrev) / steps;
+        double ffVel = (impl->mTarget - targetPrev) * freq * impl->mRadPerCount * cfg.mVelFF;
+
+        for (uint32_t i = 0; i < steps; ++i)
+        {
+            double motorTorque = 0;
+
+            if (!impl->mPowered)
+            {
+                impl->mIntegral = 0;
+            }
+            else if (impl->mQuickStop)
+            {
+                motorTorque = impl->velocityLoop(0, dt);
+            }
+            else
+            {
+                switch (cmd.mMode)
+                {
+                case MC_ServoControlMode::POSITION:
+                { // 周期内线性插补目标位置
+                    double target = targetPrev + step * (i + 1);
+                    double err = (target - floorCounts(impl->mPos * impl->mCountsPerRad)) * impl->mRadPerCount;
+                    motorTorque = impl->velocityLoop(cfg.mPosKp * err + ffVel, dt);
+                    break;
+                }
+
+                case MC_ServoControlMode::VELOCITY:
+                    motorTorque = impl->velocityLoop(cmd.mVel * impl->mRadPerCount, dt);
+                    break;
+
+                case MC_ServoControlMode::TORQUE:
+                default:
+                    motorTorque = fmax(-impl->mTorqueLimit, fmin(impl->mTorqueLimit, cmd.mTorque));
+                    break;
+                }
+            }
+
+            impl->integrate(motorTorque, dt);
+            impl->mMotorTorque = motorTorque;
+        }
+
+        // 由量化后的位置估计速度与加速度
+        int32_t fbPos = impl->encoder();
+        double fbVel = (int32_t)(fbPos - impl->mFbPos) * freq;
+        impl->mFbAcc = (fbVel - impl->mFbVel) * freq;
+        impl->mFbVel = fbVel;
+        impl->mFbPos = fbPos;
+    }
+
+    void SimServo::emergStop(void)
+    {
+        mImpl_->mQuickStop = true;
+    }
+
+} // namespace Uranus
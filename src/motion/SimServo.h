@@ -0,0 +1,105 @@
+/*
+ * SimServo.h
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#ifndef _URANUS_SIMSERVO_HPP_
+#define _URANUS_SIMSERVO_HPP_
+
+#include "Servo.h"
+
+namespace Uranus
+{
+
+// readVal/writeVal可访问的模型参数索引
+#define URANUS_SIMSERVO_VAL_POS_KP 1000
+#define URANUS_SIMSERVO_VAL_VEL_KP 1001
+#define URANUS_SIMSERVO_VAL_VEL_KI 1002
+#define URANUS_SIMSERVO_VAL_VEL_FF 1003
+#define URANUS_SIMSERVO_VAL_INERTIA 1004
+#define URANUS_SIMSERVO_VAL_LOAD_TORQUE 1005
+
+#pragma pack(push)
+#pragma pack(4)
+
+    struct SimServoConfig
+    {
+        uint32_t mCountsPerRev = 8192;  // 编码器每转计数，位置反馈按此量化
+        double mInertia = 2e-4;         // 电机与负载的转动惯量(kg*m^2)
+        double mViscousFriction = 1e-4; // 粘滞摩擦(N*m*s/rad)
+        double mCoulombFriction = 0.02; // 库仑摩擦(N*m)，静止时为最大静摩擦
+        double mTorqueConstant = 0.5;   // 转矩常数(N*m/A)
+        double mMaxCurrent = 6;         // 电流限制(A)
+        double mPosKp = 50;             // 驱动器位置环增益(1/s)
+        double mVelKp = 0.12;           // 速度环比例增益(N*m*s/rad)
+        double mVelKi = 15;             // 速度环积分增益(N*m/rad)
+        double mVelFF = 0;              // 驱动器速度前馈系数(0~1)
+        uint32_t mBusDelay = 1;         // 指令到达驱动器的延迟周期数
+        uint32_t mSubsteps = 8;         // 每周期的驱动器内部控制步数
+    };
+
+    /*
+     * 仿真伺服驱动器：驱动器内部以mSubsteps倍周期频率执行位置环与速度PI环，
+     * 转矩经电流限制后作用于带摩擦的刚体负载，位置反馈按编码器计数量化
+     * 位置、速度、加速度的单位与Servo一致：编码器计数、计数/s、计数/s^2
+     */
+    class SimServo : public Servo
+    {
+    public:
+        SimServo();
+        explicit SimServo(const SimServoConfig &config);
+        virtual ~SimServo();
+
+        // 修改模型参数，指令延迟队列按新的mBusDelay重建
+        bool setConfig(const SimServoConfig &config);
+        const SimServoConfig &config(void) const;
+
+        // 外部负载转矩(N*m)，如重力负载，驱动器未使能时同样作用
+        void setLoadTorque(double torque);
+
+        // 将仿真状态置于指定位置并静止
+        void reset(int32_t pos);
+
+        MC_ServoErrorCode setPower(bool powerStatus, bool &isDone) override;
+        MC_ServoErrorCode setPos(int32_t pos) override;
+        MC_ServoErrorCode setVel(int32_t vel) override;
+        MC_ServoErrorCode setTorque(double torque) override;
+        int32_t pos(void) override;
+        int32_t vel(void) override;
+        int32_t acc(void) override;
+        double torque(void) override;
+        bool readVal(int index, double &value) override;
+        bool writeVal(int index, double value) override;
+        MC_ServoErrorCode resetError(bool &isDone) override;
+        void runCycle(double freq) override;
+        void emergStop(void) override;
+
+    private:
+        class SimServoImpl;
+        SimServoImpl *mImpl_;
+    };
+
+#pragma pack(pop)
+
+}
+
+#endif /** _URANUS_SIMSERVO_HPP_ **/
@@ -40,7 +40,7 @@ namespace Uranus
 
     double Axis::frequency(void)
     {
-        return mSched->frequency();
+        return mSched->frequency() / mDivisor;
     }
 
     uint32_t Axis::tick(void)
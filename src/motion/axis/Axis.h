@@ -26,6 +26,8 @@
 #define _URANUS_AXIS_HPP_
 
 #include "AxisMotion.h"
+#include "CycleMeter.h"
+#include "SeqLock.h"
 
 namespace Uranus
 {
@@ -46,7 +48,15 @@ namespace Uranus
     private:
         Scheduler *mSched = nullptr;
         int32_t mAxisId = 0;
+        uint32_t mIndex = 0;
+        int32_t mPartition = -1;
+        uint32_t mDivisor = 1;
+        uint32_t mPhase = 0;
+        CycleMeter mMeter;
+        FunctionBlock *mCommandProxy = nullptr;
+        SeqLock<AxisSnapshot> mSnapshot;
         friend class Scheduler;
+        friend class CommandMailbox;
     };
 }
 
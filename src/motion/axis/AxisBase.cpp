@@ -386,6 +386,7 @@ namespace Uranus
         mImpl_->servoStatusMaintains();
         mImpl_->processPositionLoop();
         mImpl_->mServo->runCycle(frequency());
+        mImpl_->mServo->processValRequests();
     }
 
     void AxisBase::setServo(Servo *servo)
@@ -662,6 +663,26 @@ namespace Uranus
         return mImpl_->mServo->writeVal(index, value);
     }
 
+    bool AxisBase::servoReadValAsync(int index, uint32_t &request)
+    {
+        return mImpl_->mServo->readValAsync(index, request);
+    }
+
+    bool AxisBase::servoWriteValAsync(int index, double value, uint32_t &request)
+    {
+        return mImpl_->mServo->writeValAsync(index, value, request);
+    }
+
+    ServoValStat AxisBase::servoPollVal(uint32_t request, double &value)
+    {
+        return mImpl_->mServo->pollVal(request, value);
+    }
+
+    void AxisBase::servoCancelVal(uint32_t request)
+    {
+        mImpl_->mServo->cancelVal(request);
+    }
+
     double AxisBase::userPosToSys(double baseSysPos, double userPos, MC_Direction dir) const
     {
         double userPosNoHome = mImpl_->stripHomeOffset(baseSysPos, userPos);
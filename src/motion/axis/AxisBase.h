@@ -82,6 +82,12 @@ namespace Uranus
     
         bool servoReadVal(int index, double& value);
         bool servoWriteVal(int index, double value);
+
+        // 异步参数访问，见Servo::readValAsync
+        bool servoReadValAsync(int index, uint32_t& request);
+        bool servoWriteValAsync(int index, double value, uint32_t& request);
+        ServoValStat servoPollVal(uint32_t request, double& value);
+        void servoCancelVal(uint32_t request);
     
         double userPosToSys(double baseSysPos, double userPos, MC_Direction dir) const;
         double sysPosToUser(double sysPos) const;
@@ -51,9 +51,10 @@ namespace Uranus
         ProfilePlanner mPlanner;
     };
 
-    class HomingNode : virtual public AxisExeclNode
+    class HomingNode : public AxisExeclNode
     {
     public:
+        AxisHoming *mOwner = nullptr;
         double mPos = 0;
         double mFinalPos = 0;
         MC_HomingStep mHomingStep = MC_HomingStep::INIT;
@@ -65,7 +66,7 @@ namespace Uranus
 
     MC_ErrorCode HomingNode::onExecuting(ExeclQueue *queue, ExeclNodeExecStat &stat)
     {
-        AxisHoming *axis = dynamic_cast<AxisHoming *>(queue);
+        AxisHoming *axis = mOwner;
         ProfilePlanner *planner = &axis->mImpl_->mPlanner;
         AxisHomingInfoEx *homingInfo = &axis->mImpl_->mHomingInfo;
         MC_ErrorCode err;
@@ -165,9 +166,10 @@ namespace Uranus
     AxisHoming::AxisHoming()
     {
         mImpl_ = new AxisHomingImpl();
+        reserveNode(sizeof(HomingNode));
 
-        URANUS_ADD_HANDLER(onPowerStatusChanged, onPowerStatusChangedHandler);
-        URANUS_ADD_HANDLER(onPositionOffset, onPositionOffsetHandler);
+        URANUS_ADD_MEMBER_HANDLER(onPowerStatusChanged, onPowerStatusChangedHandler);
+        URANUS_ADD_MEMBER_HANDLER(onPositionOffset, onPositionOffsetHandler);
     }
 
     AxisHoming::~AxisHoming()
@@ -235,33 +237,26 @@ namespace Uranus
             return MC_ErrorCode::POS_ILLEGAL;
 
         HomingNode *node;
-        MC_ErrorCode err = pushAndNewData(
-            [&node, pos](void *baseNode) -> AxisExeclNode *
-            {
-                node = (HomingNode *)baseNode;
-                new (node) HomingNode();
-                node->mPos = pos;
-                return node;
-            },
-            (bufferMode == MC_BufferMode::ABORTING), fb, MC_AxisStatus::HOMING, MC_AxisStatus::STANDSTILL, customId);
+        MC_ErrorCode err = emplace(node, (bufferMode == MC_BufferMode::ABORTING), fb, MC_AxisStatus::HOMING,
+                                   MC_AxisStatus::STANDSTILL, customId);
 
         if (MC_ErrorCode::GOOD != err)
             return err;
 
+        node->mOwner = this;
+        node->mPos = pos;
         return MC_ErrorCode::GOOD;
     }
 
-    void AxisHoming::onPowerStatusChangedHandler(AxisBase *this_, bool powerStatus)
+    void AxisHoming::onPowerStatusChangedHandler(bool powerStatus)
     {
-        AxisHoming *this__ = dynamic_cast<AxisHoming *>(this_);
         if (powerStatus)
-            this__->mImpl_->mPlanner.setFrequency(this__->frequency());
+            mImpl_->mPlanner.setFrequency(frequency());
     }
 
-    void AxisHoming::onPositionOffsetHandler(AxisBase *this_, double positionOffset)
+    void AxisHoming::onPositionOffsetHandler(double positionOffset)
     {
-        AxisHoming *this__ = dynamic_cast<AxisHoming *>(this_);
-        this__->mImpl_->mPlanner.setPositionOffset(positionOffset);
+        mImpl_->mPlanner.setPositionOffset(positionOffset);
     }
 
 } // namespace Uranus
@@ -46,8 +46,8 @@ namespace Uranus
             int32_t customId = 0);
 
     private:
-        static void onPowerStatusChangedHandler(AxisBase *this_, bool powerStatus);
-        static void onPositionOffsetHandler(AxisBase *this_, double positionOffset);
+        void onPowerStatusChangedHandler(bool powerStatus);
+        void onPositionOffsetHandler(double positionOffset);
 
     private:
         class AxisHomingImpl;
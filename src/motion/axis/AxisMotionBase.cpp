@@ -37,7 +37,7 @@ namespace Uranus
 
     MC_ErrorCode AxisExeclNode::onActive(ExeclQueue *queue)
     {
-        AxisMotionBase *axis = dynamic_cast<AxisMotionBase *>(queue);
+        AxisMotionBase *axis = mAxis;
         MC_ErrorCode err = axis->setStatus(mStatusActive);
         if (MC_ErrorCode::GOOD != err)
             return err;
@@ -51,7 +51,7 @@ namespace Uranus
 
     void AxisExeclNode::onAborted(ExeclQueue *queue)
     {
-        AxisMotionBase *axis = dynamic_cast<AxisMotionBase *>(queue);
+        AxisMotionBase *axis = mAxis;
         axis->operationAborted(mFb, mNodeCustomId);
         if (mFb)
             mFb->onOperationAborted(mNodeCustomId);
@@ -59,7 +59,7 @@ namespace Uranus
 
     void AxisExeclNode::onDone(ExeclQueue *queue, bool &isHold)
     {
-        AxisMotionBase *axis = dynamic_cast<AxisMotionBase *>(queue);
+        AxisMotionBase *axis = mAxis;
         axis->setStatus(mStatusDone);
         axis->operationDone(mFb, mNodeCustomId);
         if (mFb)
@@ -68,7 +68,7 @@ namespace Uranus
 
     void AxisExeclNode::onError(ExeclQueue *queue, MC_ErrorCode errorCode)
     {
-        AxisMotionBase *axis = dynamic_cast<AxisMotionBase *>(queue);
+        AxisMotionBase *axis = mAxis;
         axis->operationError(mFb, mNodeCustomId, errorCode);
         if (mFb)
             mFb->onOperationError(errorCode, mNodeCustomId);
@@ -77,9 +77,9 @@ namespace Uranus
     AxisMotionBase::AxisMotionBase()
     {
         mImpl_ = new AxisMotionBaseImpl();
-        URANUS_ADD_HANDLER(onError, onErrorHandler);
-        URANUS_ADD_HANDLER(onPowerStatusChanged, onPowerStatusChangedHandler);
-        URANUS_ADD_HANDLER(onPositionOffset, onPositionOffsetHandler);
+        URANUS_ADD_MEMBER_HANDLER(onError, onErrorHandler);
+        URANUS_ADD_MEMBER_HANDLER(onPowerStatusChanged, onPowerStatusChangedHandler);
+        URANUS_ADD_MEMBER_HANDLER(onPositionOffset, onPositionOffsetHandler);
     }
 
     AxisMotionBase::~AxisMotionBase()
@@ -93,9 +93,7 @@ namespace Uranus
         AxisBase::runCycle();
     }
 
-    MC_ErrorCode AxisMotionBase::pushAndNewData(const std::function<AxisExeclNode *(void *)> &constructor, bool abortFlag,
-                                                FunctionBlock *fb, MC_AxisStatus statusActive, MC_AxisStatus statusDone,
-                                                int32_t nodeCustomId)
+    MC_ErrorCode AxisMotionBase::checkEmplace(bool abortFlag, MC_AxisStatus statusActive)
     {
         if (MC_ErrorCode::GOOD != errorCode())
             return errorCode();
@@ -110,47 +108,33 @@ namespace Uranus
                 return err;
         }
 
-        return ExeclQueue::pushAndNewData(
-            [&constructor, fb, statusActive, statusDone, nodeCustomId](void *baseNode) -> AxisExeclNode *
-            {
-                AxisExeclNode *node = constructor(baseNode);
-                node->mFb = fb;
-                node->mStatusActive = statusActive;
-                node->mStatusDone = statusDone;
-                node->mNodeCustomId = nodeCustomId;
-                return node;
-            },
-            abortFlag);
+        return MC_ErrorCode::GOOD;
     }
 
-    void AxisMotionBase::onErrorHandler(AxisBase *this_, MC_ErrorCode errorCode)
+    void AxisMotionBase::onErrorHandler(MC_ErrorCode errorCode)
     {
-        AxisMotionBase *this__ = dynamic_cast<AxisMotionBase *>(this_);
-        this__->setAllNodesError(errorCode);
+        setAllNodesError(errorCode);
     }
 
-    void AxisMotionBase::onPowerStatusChangedHandler(AxisBase *this_, bool powerStatus)
+    void AxisMotionBase::onPowerStatusChangedHandler(bool powerStatus)
     {
-        AxisMotionBase *this__ = dynamic_cast<AxisMotionBase *>(this_);
-        this__->setAllNodesAborted();
+        setAllNodesAborted();
         /*
-        AxesGroupBase* group = this__->mImpl_->mGroup;
+        AxesGroupBase* group = mImpl_->mGroup;
         if(group) {
-            URANUS_CALL_EVENT(group->onAxisPowerStatusChanged, group, this__, powerStatus);
+            URANUS_CALL_EVENT(group->onAxisPowerStatusChanged, group, this, powerStatus);
         }
         */
     }
 
-    void AxisMotionBase::onPositionOffsetHandler(AxisBase *this_, double positionOffset)
+    void AxisMotionBase::onPositionOffsetHandler(double positionOffset)
     {
-        AxisMotionBase *this__ = dynamic_cast<AxisMotionBase *>(this_);
-
-        AxisExeclNode *node = dynamic_cast<AxisExeclNode *>(this__->ExeclQueue::front());
+        AxisExeclNode *node = static_cast<AxisExeclNode *>(ExeclQueue::front());
 
         while (node)
         {
-            node->onPositionOffset(this__, positionOffset);
-            node = dynamic_cast<AxisExeclNode *>(this__->ExeclQueue::next(node));
+            node->onPositionOffset(this, positionOffset);
+            node = static_cast<AxisExeclNode *>(ExeclQueue::next(node));
         }
     }
 
@@ -34,9 +34,12 @@ namespace Uranus
 
     // class AxesGroupBase;
     class FunctionBlock;
-    class AxisExeclNode : virtual public ExeclNode
+    class ProfileNode;
+    class AxisMotionBase;
+    class AxisExeclNode : public ExeclNode
     {
     public:
+        AxisMotionBase *mAxis = nullptr; // 所属轴，入队时设定
         FunctionBlock *mFb = nullptr;
         MC_AxisStatus mStatusActive = MC_AxisStatus::STANDSTILL;
         MC_AxisStatus mStatusDone = MC_AxisStatus::STANDSTILL;
@@ -50,6 +53,9 @@ namespace Uranus
 
     public:
         virtual void onPositionOffset(ExeclQueue *queue, double positionOffset) = 0;
+
+        // 轨迹节点返回其规划参数，其余节点返回nullptr
+        virtual ProfileNode *profileNode(void) { return nullptr; }
     };
 
     class AxisMotionBase : virtual public AxisStatus,
@@ -60,13 +66,17 @@ namespace Uranus
         AxisMotionBase();
         virtual ~AxisMotionBase();
         void runCycle(void);
-        MC_ErrorCode pushAndNewData(
-            const std::function<AxisExeclNode *(void *)> &constructor,
+
+        // 检查轴状态后在队列尾部原位构造节点T
+        template <typename T, typename... Args>
+        MC_ErrorCode emplace(
+            T *&node,
             bool abortFlag,
             FunctionBlock *fb,
             MC_AxisStatus statusActive,
             MC_AxisStatus statusDone,
-            int32_t nodeCustomId);
+            int32_t nodeCustomId,
+            Args &&...args);
 
     public: // 外部继承获取
         virtual void operationActive(FunctionBlock *fb, int32_t customId) {}
@@ -76,15 +86,39 @@ namespace Uranus
             FunctionBlock *fb, int32_t customId, MC_ErrorCode errorCode) {}
 
     private:
-        static void onErrorHandler(AxisBase *this_, MC_ErrorCode errorCode);
-        static void onPowerStatusChangedHandler(AxisBase *this_, bool powerStatus);
-        static void onPositionOffsetHandler(AxisBase *this_, double positionOffset);
+        MC_ErrorCode checkEmplace(bool abortFlag, MC_AxisStatus statusActive);
+
+    private:
+        void onErrorHandler(MC_ErrorCode errorCode);
+        void onPowerStatusChangedHandler(bool powerStatus);
+        void onPositionOffsetHandler(double positionOffset);
 
     private:
         class AxisMotionBaseImpl;
         AxisMotionBaseImpl *mImpl_;
     };
 
+    template <typename T, typename... Args>
+    inline MC_ErrorCode AxisMotionBase::emplace(T *&node, bool abortFlag, FunctionBlock *fb,
+                                                MC_AxisStatus statusActive, MC_AxisStatus statusDone,
+                                                int32_t nodeCustomId, Args &&...args)
+    {
+        MC_ErrorCode err = checkEmplace(abortFlag, statusActive);
+        if (MC_ErrorCode::GOOD != err)
+            return err;
+
+        err = ExeclQueue::emplace(node, abortFlag, std::forward<Args>(args)...);
+        if (MC_ErrorCode::GOOD != err)
+            return err;
+
+        node->mAxis = this;
+        node->mFb = fb;
+        node->mStatusActive = statusActive;
+        node->mStatusDone = statusDone;
+        node->mNodeCustomId = nodeCustomId;
+        return MC_ErrorCode::GOOD;
+    }
+
 }
 
 #endif /** _URANUS_AXISMOTIONBASE_HPP_ **/
@@ -26,16 +26,33 @@
 #include "Event.h"
 #include "FunctionBlock.h"
 #include "MathUtils.h"
+#include "PlanCache.h"
+#include "PlanWorker.h"
+#include "ProfileBatch.h"
 #include "ProfilesPlanner.h"
 
 namespace Uranus
 {
 
-class MoveNode : virtual public AxisExeclNode, public ProfileNode
+// 前瞻时按距离计算可达速度的余量，避免浮点误差导致终速度不可达
+#define URANUS_LOOKAHEAD_MARGIN 0.95
+
+class MoveNode : public AxisExeclNode, public ProfileNode
 {
   public:
+    AxisMove *mOwner = nullptr;
     bool mNeedPlan = true;
+    bool mPlanned = false; // 已开始执行
     bool mIsHold = false;
+    bool mBlendOut = false;  // 以非零速度衔接下一节点
+    bool mHoldUpdated = false; // 保持执行时参数被更新，到达新速度后再次通知功能块
+    MC_BufferMode mBufferMode = MC_BufferMode::ABORTING;
+    double mJunctionVel = 0; // 前瞻计算的衔接速度(绝对值)
+
+    virtual ProfileNode *profileNode(void) override
+    {
+        return this;
+    }
 
   protected:
     virtual MC_ErrorCode onExecuting(ExeclQueue *queue, ExeclNodeExecStat &stat) override;
@@ -48,27 +65,76 @@ class AxisMove::AxisMoveImpl
   public:
     AxisMove *mThis_;
     ProfilesPlanner mPlanner;
+    bool mLookAhead = false;
+    PlanCache mCache;
+
+    PlanSlot mSlot;
+    std::atomic<PlanWorker *> mWorker{nullptr};
+    uint32_t mPlanSeq = 0;    // 规划器每次重新规划后自增
+    bool mPlanValid = false; // 当前节点规划成功
+    bool mBlendIn = false;   // 上一节点以非零速度结束，下一节点从其终点状态开始
+
+    ProfileBatch *mBatch = nullptr; // 批量步进，nullptr时由规划器单独步进
+    uint32_t mLane = 0;
+    uint64_t mBatchStep = 0;  // 规划器与批量中的轴状态一致时的步数
+    bool mBatchSync = false;
 
   public:
     MC_ErrorCode addMove(FunctionBlock *fb, double pos, double vel, double acc, double dec, double endVel, double jerk,
                          MC_ShiftingMode shiftingMode, MC_Direction dir, MC_BufferMode bufferMode,
                          MC_AxisStatus statusActive, MC_AxisStatus statusDone, bool isHold, int32_t customId);
+
+    MC_ErrorCode updateMove(FunctionBlock *fb, double pos, double vel, double acc, double dec, double endVel,
+                            double jerk, MC_ShiftingMode shiftingMode, MC_Direction dir);
+    MoveNode *findMoveNode(FunctionBlock *fb) const;
+
+    void lookAhead(void);
+    MoveNode *toMoveNode(ExeclNode *node) const;
+    double nodeStartPos(const MoveNode *node) const;
+    double junctionCap(const MoveNode *prev, const MoveNode *node) const;
+    static double reachableVel(double startVel, double dist, double acc, double jerk);
+    void prePlan(MoveNode *node);
+    bool step(void);
 };
 
 MC_ErrorCode MoveNode::onExecuting(ExeclQueue *queue, ExeclNodeExecStat &stat)
 {
-    AxisMove *axis = dynamic_cast<AxisMove *>(queue);
-    ProfilesPlanner *planner = &axis->mImpl_->mPlanner;
+    AxisMove *axis = mOwner;
+    AxisMove::AxisMoveImpl *impl = axis->mImpl_;
+    ProfilesPlanner *planner = &impl->mPlanner;
 
     if (mNeedPlan)
     {
         mNeedPlan = false;
+        impl->mBatchSync = false;
+
+        // 上一节点最后一个采样在其终点之前，从终点状态开始才能与剩余时间衔接，否则会丢失不足一个周期的行程
+        double startPos = axis->cmdPosition();
+        double startVel = axis->cmdVelocity();
+        double startAcc = axis->cmdAcceleration();
+        if (!mPlanned && impl->mBlendIn)
+        {
+            startPos = planner->input_info.end_position;
+            startVel = planner->input_info.end_vel;
+            startAcc = 0;
+        }
+        impl->mBlendIn = false;
+
+        if (mFreePos && mPlanned) // 更新后的速度运动从当前状态计算终点
+            mEndPos = axis->cmdPosition() + ProfilePlanner::calculateDist(axis->cmdVelocity(), mVel, mAcc, mDec,
+                                                                          mJerk, axis->cmdAcceleration());
+        mPlanned = true;
 
-        bool ret = planner->plan(this, axis->cmdPosition(), axis->cmdVelocity(), axis->cmdAcceleration());
+        // 优先使用后台线程的预规划结果，不可用时同步规划
+        bool ret = (impl->mWorker.load(std::memory_order_acquire) &&
+                    impl->mSlot.take(this, *this, *planner, startPos, startVel, startAcc)) ||
+                   planner->plan(this, startPos, startVel, startAcc);
+        impl->mPlanValid = ret;
+        ++impl->mPlanSeq;
 
         axis->printLog(MC_LogLevel::DEBUG,
                        "MovePos %lf -> %lf, Vel %lf -> %lf, With MaxVel %lf, MaxAcc %lf, MaxDec %lf, Jerk %lf\n",
-                       axis->cmdPosition(), mEndPos, axis->cmdVelocity(), mEndVel, mVel, mAcc, mDec, mJerk);
+                       startPos, mEndPos, startVel, mEndVel, mVel, mAcc, mDec, mJerk);
 
         if (!ret)
         {
@@ -79,14 +145,32 @@ MC_ErrorCode MoveNode::onExecuting(ExeclQueue *queue, ExeclNodeExecStat &stat)
         }
     }
 
-    if (planner->execute())
+    impl->prePlan(this);
+
+    if (impl->step())
+    {
         stat = ExeclNodeExecStat::DONE;
 
+        // 保持节点的完成状态不再经过队列，由节点自行通知
+        if (mHoldUpdated)
+        {
+            mHoldUpdated = false;
+            if (mFb)
+                mFb->onOperationDone(mNodeCustomId);
+        }
+    }
+
     return axis->setPosition(planner->getPosition(), planner->getVelocity(), planner->getAcceleration());
 }
 
 void MoveNode::onDone(ExeclQueue *queue, bool &isHold)
 {
+    if (mBlendOut) // 轴不停止地进入下一节点，保持运动状态
+        mStatusDone = mStatusActive;
+
+    AxisMove::AxisMoveImpl *impl = mOwner->mImpl_;
+    impl->mBlendIn = impl->mPlanValid && mEndVel != 0.0;
+
     AxisExeclNode::onDone(queue, isHold);
     isHold = mIsHold;
 }
@@ -102,9 +186,24 @@ MC_ErrorCode AxisMove::AxisMoveImpl::addMove(FunctionBlock *fb, double pos, doub
                                              MC_BufferMode bufferMode, MC_AxisStatus statusActive,
                                              MC_AxisStatus statusDone, bool isHold, int32_t customId)
 {
-    MoveNode *node, *nodePrev;
+    MoveNode *node;
+    ProfileNode *nodePrev;
     MC_ErrorCode err;
 
+    switch (bufferMode)
+    {
+    case MC_BufferMode::ABORTING:
+    case MC_BufferMode::BUFFERED:
+    case MC_BufferMode::BLENDING_LOW:
+    case MC_BufferMode::BLENDING_PREVIOUS:
+    case MC_BufferMode::BLENDING_NEXT:
+    case MC_BufferMode::BLENDING_HIGH:
+        break;
+
+    default:
+        return MC_ErrorCode::BLENDING_MODE_ILLEGAL;
+    }
+
     // 速度参数检测
     if ((vel < 0 && !std::isnan(pos)) || !std::isfinite(vel))
         return MC_ErrorCode::VEL_ILLEGAL;
@@ -123,7 +222,7 @@ MC_ErrorCode AxisMove::AxisMoveImpl::addMove(FunctionBlock *fb, double pos, doub
     { // 使用最后一个功能块终点位置
         if (!mThis_->operationRemains())
             goto USE_CURRENT;
-        nodePrev = dynamic_cast<MoveNode *>(mThis_->back());
+        nodePrev = static_cast<AxisExeclNode *>(mThis_->back())->profileNode();
         if (!nodePrev)
             return MC_ErrorCode::FAILED_TO_BUFFER;
         startPos = nodePrev->mEndPos;
@@ -139,9 +238,10 @@ MC_ErrorCode AxisMove::AxisMoveImpl::addMove(FunctionBlock *fb, double pos, doub
     }
 
     // 特殊位置处理
-    if (std::isnan(pos))
+    bool freePos = std::isnan(pos);
+    if (freePos)
     { // 不清楚位置
-        pos = ProfilePlanner::calculateDist(startVel, vel, acc, dec);
+        pos = ProfilePlanner::calculateDist(startVel, vel, acc, dec, jerk, startAcc);
         pos += startPos;
     }
     else
@@ -164,46 +264,374 @@ MC_ErrorCode AxisMove::AxisMoveImpl::addMove(FunctionBlock *fb, double pos, doub
     }
 
     // 添加队列
-    err = mThis_->pushAndNewData(
-        [&](void *baseNode) -> AxisExeclNode * {
-            // 构造数据
-            node = (MoveNode *)baseNode;
-            new (node) MoveNode();
-            node->mStartPos = startPos;
-            node->mStartVel = startVel;
-            node->mStartAcc = startAcc;
-            node->mEndPos = pos;
-            node->mEndVel = endVel;
-            node->mEndAcc = 0;
-            node->mVel = vel;
-            node->mAcc = acc;
-            node->mDec = dec;
-            node->mJerk = jerk;
+    err = mThis_->emplace(node, (bufferMode == MC_BufferMode::ABORTING), fb, statusActive, statusDone, customId);
+    if (MC_ErrorCode::GOOD != err)
+        return err;
+
+    // 构造数据
+    node->mOwner = mThis_;
+    node->mStartPos = startPos;
+    node->mStartVel = startVel;
+    node->mStartAcc = startAcc;
+    node->mEndPos = pos;
+    node->mEndVel = endVel;
+    node->mEndAcc = 0;
+    node->mVel = vel;
+    node->mAcc = acc;
+    node->mDec = dec;
+    node->mJerk = jerk;
+    node->mFreePos = freePos;
+
+    node->mIsHold = isHold;
+    node->mBufferMode = bufferMode;
+
+    // 混合模式或开启前瞻时计算与前面节点的衔接速度
+    if (!freePos && bufferMode != MC_BufferMode::ABORTING && (mLookAhead || bufferMode != MC_BufferMode::BUFFERED))
+        lookAhead();
+
+    return err;
+}
+
+MC_ErrorCode AxisMove::AxisMoveImpl::updateMove(FunctionBlock *fb, double pos, double vel, double acc, double dec,
+                                                double endVel, double jerk, MC_ShiftingMode shiftingMode,
+                                                MC_Direction dir)
+{
+    // 参数检测与addMove一致
+    if ((vel < 0 && !std::isnan(pos)) || !std::isfinite(vel))
+        return MC_ErrorCode::VEL_ILLEGAL;
+
+    if (acc <= 0 || !std::isfinite(acc) || dec <= 0 || !std::isfinite(dec))
+        return MC_ErrorCode::ACC_ILLEGAL;
+
+    if (std::isinf(pos))
+        return MC_ErrorCode::POS_ILLEGAL;
+
+    MoveNode *node = findMoveNode(fb);
+    if (!node || node->mFreePos != std::isnan(pos))
+        return MC_ErrorCode::GOOD; // 运动已结束
+
+    if (node->mFreePos)
+    { // 正在执行的节点在重新规划时按当前状态修正终点
+        if (node->mPlanned)
+            pos = mThis_->cmdPosition() + ProfilePlanner::calculateDist(mThis_->cmdVelocity(), vel, acc, dec, jerk,
+                                                                        mThis_->cmdAcceleration());
+        else
+            pos = node->mStartPos +
+                  ProfilePlanner::calculateDist(node->mStartVel, vel, acc, dec, jerk, node->mStartAcc);
+    }
+    else
+    {
+        switch (shiftingMode)
+        {
+        case MC_ShiftingMode::ABSOLUTE:
+            pos = mThis_->userPosToSys(node->mStartPos, pos, dir);
+            break;
+
+        case MC_ShiftingMode::RELATIVE:
+        case MC_ShiftingMode::ADDITIVE:
+            pos += node->mStartPos;
+            break;
 
-            node->mIsHold = isHold;
+        default:
+            return MC_ErrorCode::SHIFTING_MODE_ILLEGAL;
+        }
+    }
+
+    // 参数未变化时不重新规划，功能块可以每周期调用
+    if ((node->mFreePos || pos == node->mEndPos) && vel == node->mVel && acc == node->mAcc && dec == node->mDec &&
+        jerk == node->mJerk)
+        return MC_ErrorCode::GOOD;
+
+    bool isHold = (node == mThis_->holdNode());
+    MoveNode *next = isHold ? nullptr : toMoveNode(mThis_->ExeclQueue::next(node));
+    if (next)
+    { // 后续节点从新的终点开始
+        double offset = pos - node->mEndPos;
+        next->mStartPos += offset;
+        if (next->mFreePos)
+            next->mEndPos += offset;
+        next->mStartVel = endVel;
+    }
+
+    node->mEndPos = pos;
+    node->mEndVel = endVel;
+    node->mVel = vel;
+    node->mAcc = acc;
+    node->mDec = dec;
+    node->mJerk = jerk;
+    node->mBlendOut = false;
+    node->mNeedPlan = true; // 正在执行时下一周期从当前状态重新规划
+
+    if (isHold)
+    { // 已到达速度的保持节点重新进入加减速
+        node->mHoldUpdated = true;
+        if (fb)
+            fb->onOperationActive(node->mNodeCustomId);
+    }
+
+    // 重新计算与前后节点的衔接速度
+    if (!isHold && !node->mFreePos)
+        lookAhead();
+
+    return MC_ErrorCode::GOOD;
+}
+
+MoveNode *AxisMove::AxisMoveImpl::findMoveNode(FunctionBlock *fb) const
+{
+    if (!fb)
+        return nullptr;
+
+    MoveNode *node = toMoveNode(mThis_->holdNode());
+    if (node && node->mFb == fb)
+        return node;
+
+    for (ExeclNode *one = mThis_->front(); one; one = mThis_->ExeclQueue::next(one))
+    {
+        node = toMoveNode(one);
+        if (node && node->mFb == fb)
             return node;
-        },
-        (bufferMode == MC_BufferMode::ABORTING), fb, statusActive, statusDone, customId);
+    }
 
-    return err;
+    return nullptr;
+}
+
+MoveNode *AxisMove::AxisMoveImpl::toMoveNode(ExeclNode *node) const
+{
+    if (!node)
+        return nullptr;
+
+    // 只有MoveNode带有规划参数
+    ProfileNode *profile = static_cast<AxisExeclNode *>(node)->profileNode();
+    return profile ? static_cast<MoveNode *>(profile) : nullptr;
+}
+
+double AxisMove::AxisMoveImpl::nodeStartPos(const MoveNode *node) const
+{
+    // 已规划(正在执行)的节点从当前指令位置开始
+    return node->mPlanned ? mThis_->cmdPosition() : node->mStartPos;
+}
+
+double AxisMove::AxisMoveImpl::junctionCap(const MoveNode *prev, const MoveNode *node) const
+{
+    // 混合模式由后一个节点指定
+    switch (node->mBufferMode)
+    {
+    case MC_BufferMode::BLENDING_LOW:
+        return fmin(prev->mVel, node->mVel);
+    case MC_BufferMode::BLENDING_PREVIOUS:
+        return prev->mVel;
+    case MC_BufferMode::BLENDING_NEXT:
+        return node->mVel;
+    case MC_BufferMode::BLENDING_HIGH:
+        return fmax(prev->mVel, node->mVel);
+    default:
+        return mLookAhead ? fmin(prev->mVel, node->mVel) : 0.0;
+    }
+}
+
+double AxisMove::AxisMoveImpl::reachableVel(double startVel, double dist, double acc, double jerk)
+{
+    double vel = sqrt(__square(startVel) + 2 * acc * dist);
+    if (jerk <= 0.0)
+        return vel;
+
+    // S曲线所需距离更长，在梯形结果以内二分
+    double lo = startVel, hi = vel;
+    for (int i = 0; i < 40; ++i)
+    {
+        double mid = (lo + hi) / 2;
+        if (ProfilePlanner::calculateDist(startVel, mid, acc, acc, jerk, 0) <= dist)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+void AxisMove::AxisMoveImpl::prePlan(MoveNode *node)
+{
+    PlanWorker *worker = mWorker.load(std::memory_order_acquire);
+    if (!worker || !mPlanValid)
+        return;
+
+    // 只预规划紧接当前节点且起始状态由当前节点决定的节点
+    if (node == mThis_->holdNode())
+        return;
+
+    MoveNode *next = toMoveNode(mThis_->ExeclQueue::next(node));
+    if (!next || !next->mNeedPlan || next->mPlanned || (next->mFreePos && next->mJerk > 0.0))
+        return;
+
+    if (mSlot.submit(next, mPlanSeq, *next, mPlanner))
+        worker->notify();
+}
+
+bool AxisMove::AxisMoveImpl::step(void)
+{
+    // 批量已替本轴前进了一个tick时直接取结果，否则单独步进并重新载入批量
+    bool isDone;
+    if (mBatchSync && mBatch->steps() == mBatchStep + 1 && mBatch->store(mLane, mPlanner, isDone))
+    {
+        ++mBatchStep;
+        return isDone;
+    }
+
+    isDone = mPlanner.execute();
+    if (mBatch)
+    {
+        mBatch->load(mLane, mPlanner);
+        mBatchStep = mBatch->steps();
+        mBatchSync = true;
+    }
+
+    return isDone;
+}
+
+void AxisMove::AxisMoveImpl::lookAhead(void)
+{
+    MoveNode *tail = toMoveNode(mThis_->back());
+    if (!tail || tail->mFreePos)
+        return;
+
+    // 反向：衔接速度不超过混合模式给定的速度，且在下一节点内能减速到其终速度
+    double dir = (tail->mEndPos >= nodeStartPos(tail)) ? 1.0 : -1.0;
+    tail->mJunctionVel = (tail->mEndVel * dir > 0) ? fabs(tail->mEndVel) : 0.0;
+
+    MoveNode *head = tail;
+    MoveNode *prev;
+    while ((prev = toMoveNode(mThis_->ExeclQueue::prev(head))) && !prev->mFreePos)
+    {
+        double startPos = nodeStartPos(prev);
+        double dist = fabs(head->mEndPos - prev->mEndPos);
+        double prevDist = fabs(prev->mEndPos - startPos);
+        double prevDir = (prev->mEndPos >= startPos) ? 1.0 : -1.0;
+        double headDir = (head->mEndPos >= prev->mEndPos) ? 1.0 : -1.0;
+
+        if (__iszero(dist) || __iszero(prevDist) || prevDir != headDir)
+        {
+            prev->mJunctionVel = 0;
+        }
+        else
+        {
+            prev->mJunctionVel = fmin(junctionCap(prev, head), reachableVel(head->mJunctionVel,
+                                                                            dist * URANUS_LOOKAHEAD_MARGIN,
+                                                                            head->mDec, head->mJerk));
+        }
+
+        head = prev;
+    }
+
+    // 正向：从链首的起始速度出发，在本节点内能加速到衔接速度
+    double startPos = nodeStartPos(head);
+    dir = (head->mEndPos >= startPos) ? 1.0 : -1.0;
+    double vel = head->mPlanned ? mThis_->cmdVelocity() : head->mStartVel;
+    vel = fmax(vel * dir, 0.0);
+
+    for (MoveNode *node = head; node != tail; node = toMoveNode(mThis_->ExeclQueue::next(node)))
+    {
+        MoveNode *next = toMoveNode(mThis_->ExeclQueue::next(node));
+        startPos = nodeStartPos(node);
+        dir = (node->mEndPos >= startPos) ? 1.0 : -1.0;
+
+        double junction = fmin(node->mJunctionVel, reachableVel(vel, fabs(node->mEndPos - startPos) *
+                                                                             URANUS_LOOKAHEAD_MARGIN,
+                                                                node->mAcc, node->mJerk));
+
+        // 正在执行的S曲线节点不重新规划
+        if (node->mPlanned && node->mJerk > 0.0)
+            junction = fmin(junction, fabs(node->mEndVel));
+
+        double endVel = junction * dir;
+        if (endVel != node->mEndVel)
+        {
+            node->mEndVel = endVel;
+            node->mBlendOut = (junction != 0.0);
+            next->mStartVel = endVel;
+
+            // 正在执行的节点在下一周期按新的终速度重新规划
+            node->mNeedPlan = true;
+        }
+
+        vel = junction;
+    }
 }
 
 AxisMove::AxisMove()
 {
     mImpl_ = new AxisMoveImpl();
     mImpl_->mThis_ = this;
-
-    URANUS_ADD_HANDLER(onPowerStatusChanged, onPowerStatusChangedHandler);
-    URANUS_ADD_HANDLER(onPositionOffset, onPositionOffsetHandler);
-    URANUS_ADD_HANDLER(onAllNodesAborted, onAllNodesAbortedHandler);
-    URANUS_ADD_HANDLER(onAllNodesError, onAllNodesErrorHandler);
+    // 预规划始终使用轴的缓存，缓存条目数为0时不查找
+    mImpl_->mSlot.setCache(&mImpl_->mCache);
+    reserveNode(sizeof(MoveNode));
+
+    URANUS_ADD_MEMBER_HANDLER(onPowerStatusChanged, onPowerStatusChangedHandler);
+    URANUS_ADD_MEMBER_HANDLER(onPositionOffset, onPositionOffsetHandler);
+    URANUS_ADD_MEMBER_HANDLER(onAllNodesAborted, onAllNodesAbortedHandler);
+    URANUS_ADD_MEMBER_HANDLER(onAllNodesError, onAllNodesErrorHandler);
 }
 
 AxisMove::~AxisMove()
 {
+    setPlanWorker(nullptr);
     delete mImpl_;
 }
 
+void AxisMove::setPlanWorker(PlanWorker *worker)
+{
+    PlanWorker *old = mImpl_->mWorker.exchange(worker, std::memory_order_acq_rel);
+    if (old == worker)
+        return;
+
+    if (old)
+        old->detach(&mImpl_->mSlot);
+
+    if (worker)
+        worker->attach(&mImpl_->mSlot);
+}
+
+PlanWorker *AxisMove::planWorker(void) const
+{
+    return mImpl_->mWorker.load(std::memory_order_acquire);
+}
+
+void AxisMove::setProfileBatch(ProfileBatch *batch, uint32_t lane)
+{
+    mImpl_->mBatch = batch;
+    mImpl_->mLane = lane;
+    mImpl_->mBatchSync = false;
+}
+
+bool AxisMove::setPlanCacheSize(uint32_t size)
+{
+    if (busy())
+        return false;
+
+    mImpl_->mCache.setSize(size);
+    mImpl_->mPlanner.setCache(size ? &mImpl_->mCache : nullptr);
+    return true;
+}
+
+void AxisMove::readPlanCacheStatistics(PlanCacheStatistics &stat) const
+{
+    mImpl_->mCache.readStatistics(stat);
+}
+
+void AxisMove::resetPlanCacheStatistics(void)
+{
+    mImpl_->mCache.resetStatistics();
+}
+
+void AxisMove::setLookAhead(bool enable)
+{
+    mImpl_->mLookAhead = enable;
+}
+
+bool AxisMove::lookAhead(void) const
+{
+    return mImpl_->mLookAhead;
+}
+
 MC_ErrorCode AxisMove::addMovePos(FunctionBlock *fb, double pos, double vel, double acc, double dec, double jerk,
                                   MC_ShiftingMode shiftingMode, MC_Direction dir, MC_BufferMode bufferMode,
                                   int32_t customId)
@@ -248,6 +676,23 @@ MC_ErrorCode AxisMove::addStop(FunctionBlock *fb, double dec, double jerk, int32
         MC_BufferMode::ABORTING, MC_AxisStatus::STOPPING, MC_AxisStatus::STOPPING, false, customId);
 }
 
+MC_ErrorCode AxisMove::updateMovePos(FunctionBlock *fb, double pos, double vel, double acc, double dec, double jerk,
+                                     MC_ShiftingMode shiftingMode, MC_Direction dir)
+{
+    if (!vel)
+        return MC_ErrorCode::VEL_ILLEGAL;
+
+    return mImpl_->updateMove(fb, pos, vel, acc, dec, 0, jerk, shiftingMode, dir);
+}
+
+MC_ErrorCode AxisMove::updateMoveVel(FunctionBlock *fb, double vel, double acc, double dec, double jerk)
+{
+    if (!vel)
+        return MC_ErrorCode::VEL_ILLEGAL;
+
+    return mImpl_->updateMove(fb, NAN, vel, acc, dec, vel, jerk, MC_ShiftingMode::ABSOLUTE, MC_Direction::CURRENT);
+}
+
 void AxisMove::cancelStopLater(void)
 {
     if (status() != MC_AxisStatus::STOPPING)
@@ -259,36 +704,34 @@ void AxisMove::cancelStopLater(void)
     }
     else
     {
-        AxisExeclNode *node = dynamic_cast<AxisExeclNode *>(front());
-        if (!node)
-            return;
-
+        AxisExeclNode *node = static_cast<AxisExeclNode *>(front());
         if (node->mStatusDone == MC_AxisStatus::STOPPING)
             node->mStatusDone = MC_AxisStatus::STANDSTILL;
     }
 }
 
-void AxisMove::onPowerStatusChangedHandler(AxisBase *this_, bool powerStatus)
+void AxisMove::onPowerStatusChangedHandler(bool powerStatus)
 {
-    AxisMove *this__ = dynamic_cast<AxisMove *>(this_);
     if (powerStatus)
-        this__->mImpl_->mPlanner.setFrequency(this__->frequency());
+        mImpl_->mPlanner.setFrequency(frequency());
+    mImpl_->mBatchSync = false;
+    mImpl_->mBlendIn = false;
 }
 
-void AxisMove::onPositionOffsetHandler(AxisBase *this_, double positionOffset)
+void AxisMove::onPositionOffsetHandler(double positionOffset)
 {
-    AxisMove *this__ = dynamic_cast<AxisMove *>(this_);
-    this__->mImpl_->mPlanner.setPositionOffset(positionOffset);
+    mImpl_->mPlanner.setPositionOffset(positionOffset);
+    mImpl_->mBatchSync = false;
 }
 
-void AxisMove::onAllNodesAbortedHandler(ExeclQueue *this_)
+void AxisMove::onAllNodesAbortedHandler(void)
 {
-    // AxisMove* this__ = dynamic_cast<AxisMove*>(this_);
+    mImpl_->mBlendIn = false;
 }
 
-void AxisMove::onAllNodesErrorHandler(ExeclQueue *this_, MC_ErrorCode errorCodeToSet)
+void AxisMove::onAllNodesErrorHandler(MC_ErrorCode errorCodeToSet)
 {
-    // AxisMove* this__ = dynamic_cast<AxisMove*>(this_);
+    mImpl_->mBlendIn = false;
 }
 
 } // namespace Uranus
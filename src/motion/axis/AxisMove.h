@@ -30,6 +30,8 @@
 namespace Uranus
 {
 
+    class PlanWorker;
+    class ProfileBatch;
     class AxisMove : virtual public AxisMotionBase
     {
     public:
@@ -83,13 +85,51 @@ namespace Uranus
             double jerk,
             int32_t customId = 0);
 
+        /*
+         * ContinuousUpdate：以新参数更新fb添加且尚未完成的运动，参数含义与addMovePos/addMoveVel相同
+         * 正在执行的运动在下一周期从当前位置、速度、加速度重新规划，不经过队列中止与添加
+         * fb的运动已结束时不做处理
+         */
+        MC_ErrorCode updateMovePos(
+            FunctionBlock *fb,
+            double pos,
+            double vel,
+            double acc,
+            double dec,
+            double jerk,
+            MC_ShiftingMode shiftingMode = MC_ShiftingMode::ABSOLUTE,
+            MC_Direction dir = MC_Direction::CURRENT);
+
+        MC_ErrorCode updateMoveVel(
+            FunctionBlock *fb,
+            double vel,
+            double acc,
+            double dec,
+            double jerk);
+
         void cancelStopLater(void);
 
+        // 速度前瞻：缓冲的定位运动之间按可达的最大速度衔接，不在每个点停止
+        void setLookAhead(bool enable);
+        bool lookAhead(void) const;
+
+        // 异步规划：缓冲的节点由worker提前规划，nullptr时全部同步规划
+        void setPlanWorker(PlanWorker *worker);
+        PlanWorker *planWorker(void) const;
+
+        // 批量步进：由batch的lane代替规划器逐周期步进，nullptr时单独步进，不可在runCycle期间设定
+        void setProfileBatch(ProfileBatch *batch, uint32_t lane);
+
+        // 路径缓存：重复的相对运动复用路径计算结果，size为条目数，0为禁用，只能在队列空闲时设定
+        bool setPlanCacheSize(uint32_t size);
+        void readPlanCacheStatistics(PlanCacheStatistics &stat) const;
+        void resetPlanCacheStatistics(void);
+
     private:
-        static void onPowerStatusChangedHandler(AxisBase *this_, bool powerStatus);
-        static void onPositionOffsetHandler(AxisBase *this_, double positionOffset);
-        static void onAllNodesAbortedHandler(ExeclQueue *this_);
-        static void onAllNodesErrorHandler(ExeclQueue *this_, MC_ErrorCode errorCodeToSet);
+        void onPowerStatusChangedHandler(bool powerStatus);
+        void onPositionOffsetHandler(double positionOffset);
+        void onAllNodesAbortedHandler(void);
+        void onAllNodesErrorHandler(MC_ErrorCode errorCodeToSet);
 
     private:
         class AxisMoveImpl;
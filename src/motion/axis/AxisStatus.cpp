@@ -63,8 +63,8 @@ MC_ErrorCode AxisStatus::AxisStatusImpl::statusToError(void)
 AxisStatus::AxisStatus()
 {
     mImpl_ = new AxisStatusImpl();
-    URANUS_ADD_HANDLER(onError, onErrorHandler);
-    URANUS_ADD_HANDLER(onPowerStatusChanged, onPowerStatusChangedHandler);
+    URANUS_ADD_MEMBER_HANDLER(onError, onErrorHandler);
+    URANUS_ADD_MEMBER_HANDLER(onPowerStatusChanged, onPowerStatusChangedHandler);
 }
 
 AxisStatus::~AxisStatus()
@@ -156,16 +156,14 @@ MC_ErrorCode AxisStatus::setStatus(MC_AxisStatus status)
     return MC_ErrorCode::GOOD;
 }
 
-void AxisStatus::onErrorHandler(AxisBase *this_, MC_ErrorCode errorCode)
+void AxisStatus::onErrorHandler(MC_ErrorCode errorCode)
 {
-    AxisStatus *this__ = dynamic_cast<AxisStatus *>(this_);
-    this__->mImpl_->mStatus = MC_AxisStatus::ERRORSTOP;
+    mImpl_->mStatus = MC_AxisStatus::ERRORSTOP;
 }
 
-void AxisStatus::onPowerStatusChangedHandler(AxisBase *this_, bool powerStatus)
+void AxisStatus::onPowerStatusChangedHandler(bool powerStatus)
 {
-    AxisStatus *this__ = dynamic_cast<AxisStatus *>(this_);
-    this__->mImpl_->mStatus = powerStatus ? MC_AxisStatus::STANDSTILL : MC_AxisStatus::DISABLED;
+    mImpl_->mStatus = powerStatus ? MC_AxisStatus::STANDSTILL : MC_AxisStatus::DISABLED;
 }
 
 } // namespace Uranus
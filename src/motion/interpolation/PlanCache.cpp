@@ -0,0 +1,224 @@
+/*
+ * PlanCache.cpp
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "PlanCache.h"
+
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+namespace Uranus
+{
+
+// 开放寻址的最大探测长度，查找与插入至多比较这么多个条目
+#define URANUS_PLANCACHE_PROBE 4
+
+    class PlanCache::PlanCacheImpl
+    {
+    public:
+        struct Entry
+        {
+            uint64_t mHash = 0;
+            uint64_t mStamp = 0; // 最近一次使用的时刻，0为空
+            Key mKey;
+            int mResult = 0;
+            double mEndVel = 0; // 路径计算修正后的终速度
+            ProfilePlanner::Segment mSegments[MAX_ROUTE_SEGMENT_NUM];
+        };
+
+        std::vector<Entry> mEntries; // 容量为2的幂，按哈希值定位
+        uint32_t mMask = 0;
+        uint64_t mClock = 0;
+
+        // 周期线程与规划线程共用缓存，争用时放弃本次查找/插入而不等待
+        std::atomic_flag mLock = ATOMIC_FLAG_INIT;
+
+        std::atomic<uint64_t> mHits{0};
+        std::atomic<uint64_t> mMisses{0};
+        std::atomic<uint32_t> mUsedNum{0};
+
+    public:
+        static uint64_t hash(const Key &key);
+
+        bool tryLock(void);
+        void unlock(void);
+    };
+
+    uint64_t PlanCache::PlanCacheImpl::hash(const Key &key)
+    {
+        // 按位比较，-0.0与0.0视为不同的键
+        uint64_t words[sizeof(Key) / sizeof(uint64_t)];
+        memcpy(words, &key, sizeof(Key));
+
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (uint64_t word : words)
+        {
+            h ^= word;
+            h *= 0x100000001b3ULL;
+            h ^= h >> 29;
+        }
+
+        return h;
+    }
+
+    bool PlanCache::PlanCacheImpl::tryLock(void)
+    {
+        return !mLock.test_and_set(std::memory_order_acquire);
+    }
+
+    void PlanCache::PlanCacheImpl::unlock(void)
+    {
+        mLock.clear(std::memory_order_release);
+    }
+
+    PlanCache::PlanCache()
+    {
+        mImpl_ = new PlanCacheImpl();
+    }
+
+    PlanCache::~PlanCache()
+    {
+        delete mImpl_;
+    }
+
+    void PlanCache::setSize(uint32_t size)
+    {
+        uint32_t capacity = 0;
+        if (size)
+        {
+            capacity = URANUS_PLANCACHE_PROBE;
+            while (capacity < size)
+                capacity <<= 1;
+        }
+
+        while (!mImpl_->tryLock())
+            ;
+
+        mImpl_->mEntries.assign(capacity, PlanCacheImpl::Entry());
+        mImpl_->mMask = capacity ? capacity - 1 : 0;
+        mImpl_->mClock = 0;
+        mImpl_->mUsedNum.store(0, std::memory_order_relaxed);
+
+        mImpl_->unlock();
+    }
+
+    uint32_t PlanCache::size(void) const
+    {
+        return (uint32_t)mImpl_->mEntries.size();
+    }
+
+    bool PlanCache::find(const Key &key, ProfilePlanner::Segment *segments, int &result, double &endVel)
+    {
+        if (!mImpl_->tryLock())
+            return false;
+
+        if (mImpl_->mEntries.empty())
+        {
+            mImpl_->unlock();
+            return false;
+        }
+
+        uint64_t h = PlanCacheImpl::hash(key);
+        for (uint32_t i = 0; i < URANUS_PLANCACHE_PROBE; ++i)
+        {
+            PlanCacheImpl::Entry &entry = mImpl_->mEntries[(h + i) & mImpl_->mMask];
+            if (!entry.mStamp)
+                break; // 条目不删除，遇到空位即未命中
+
+            if (entry.mHash != h || memcmp(&entry.mKey, &key, sizeof(Key)))
+                continue;
+
+            entry.mStamp = ++mImpl_->mClock;
+            memcpy(segments, entry.mSegments, sizeof(entry.mSegments));
+            result = entry.mResult;
+            endVel = entry.mEndVel;
+            mImpl_->unlock();
+            mImpl_->mHits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        mImpl_->unlock();
+        mImpl_->mMisses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void PlanCache::insert(const Key &key, const ProfilePlanner::Segment *segments, int result, double endVel)
+    {
+        if (!mImpl_->tryLock())
+            return;
+
+        if (mImpl_->mEntries.empty())
+        {
+            mImpl_->unlock();
+            return;
+        }
+
+        // 探测范围内取空位或相同的键，否则替换其中最久未使用的条目
+        uint64_t h = PlanCacheImpl::hash(key);
+        PlanCacheImpl::Entry *target = nullptr;
+        for (uint32_t i = 0; i < URANUS_PLANCACHE_PROBE; ++i)
+        {
+            PlanCacheImpl::Entry &entry = mImpl_->mEntries[(h + i) & mImpl_->mMask];
+            if (!entry.mStamp)
+            {
+                target = &entry;
+                mImpl_->mUsedNum.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+
+            if (entry.mHash == h && !memcmp(&entry.mKey, &key, sizeof(Key)))
+            {
+                target = &entry;
+                break;
+            }
+
+            if (!target || entry.mStamp < target->mStamp)
+                target = &entry;
+        }
+
+        target->mHash = h;
+        target->mStamp = ++mImpl_->mClock;
+        target->mKey = key;
+        target->mResult = result;
+        target->mEndVel = endVel;
+        memcpy(target->mSegments, segments, sizeof(target->mSegments));
+
+        mImpl_->unlock();
+    }
+
+    void PlanCache::readStatistics(PlanCacheStatistics &stat) const
+    {
+        stat.mHits = mImpl_->mHits.load(std::memory_order_relaxed);
+        stat.mMisses = mImpl_->mMisses.load(std::memory_order_relaxed);
+        stat.mSize = (uint32_t)mImpl_->mEntries.size();
+        stat.mUsed = mImpl_->mUsedNum.load(std::memory_order_relaxed);
+    }
+
+    void PlanCache::resetStatistics(void)
+    {
+        mImpl_->mHits.store(0, std::memory_order_relaxed);
+        mImpl_->mMisses.store(0, std::memory_order_relaxed);
+    }
+
+} // namespace Uranus
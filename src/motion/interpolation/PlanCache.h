@@ -0,0 +1,80 @@
+/*
+ * PlanCache.h
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#ifndef _URANUS_PLANCACHE_HPP_
+#define _URANUS_PLANCACHE_HPP_
+
+#include "Global.h"
+#include "ProfilePlanner.h"
+
+namespace Uranus
+{
+
+    /*
+     * 路径计算结果缓存：以相对位移与速度、加速度参数为键，保存相对起点的路径段、
+     * 计算结果及行程不足时修正后的终速度，命中时由ProfilePlanner平移到实际起点后照常离散化，
+     * 结果与重新计算逐位相同
+     * 以键的哈希值开放寻址，查找与插入至多比较固定个数的条目
+     * 周期线程的同步规划与异步规划线程的预规划共用一个缓存，两者争用时放弃本次查找/插入，
+     * 不会阻塞周期线程；命中统计可在其他线程读取
+     */
+    class PlanCache
+    {
+    public:
+        struct Key
+        {
+            double mShift;
+            double mStartVel;
+            double mStartAcc;
+            double mVel;
+            double mEndVel;
+            double mAcc;
+            double mDec;
+            double mJerk;
+        };
+
+        PlanCache();
+        ~PlanCache();
+
+        // 设定缓存条目数并清空缓存，按2的幂向上取整，0为禁用
+        void setSize(uint32_t size);
+        uint32_t size(void) const;
+
+        // 命中时拷贝全部MAX_ROUTE_SEGMENT_NUM个段、路径计算结果与实际终速度
+        bool find(const Key &key, ProfilePlanner::Segment *segments, int &result, double &endVel);
+
+        // 插入新结果，探测范围内已满时替换其中最久未使用的条目
+        void insert(const Key &key, const ProfilePlanner::Segment *segments, int result, double endVel);
+
+        void readStatistics(PlanCacheStatistics &stat) const;
+        void resetStatistics(void);
+
+    private:
+        class PlanCacheImpl;
+        PlanCacheImpl *mImpl_;
+    };
+
+}
+
+#endif /** _URANUS_PLANCACHE_HPP_ **/
@@ -0,0 +1,282 @@
+/*
+ * PlanWorker.cpp
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "PlanWorker.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace Uranus
+{
+
+// 规划线程无请求时的最长休眠时间(微秒)，避免丢失唤醒时请求长时间得不到处理
+#define URANUS_PLANWORKER_IDLE_US 1000
+
+    PlanSlot::PlanSlot()
+    {
+    }
+
+    bool PlanSlot::sameNode(const ProfileNode &a, const ProfileNode &b)
+    {
+        return a.mEndPos == b.mEndPos && a.mEndVel == b.mEndVel && a.mVel == b.mVel && a.mAcc == b.mAcc &&
+               a.mDec == b.mDec && a.mJerk == b.mJerk && a.mFreePos == b.mFreePos;
+    }
+
+    PlanSlot::State PlanSlot::state(void) const
+    {
+        return (State)mState.load(std::memory_order_acquire);
+    }
+
+    bool PlanSlot::submit(const void *tag, uint32_t seq, const ProfileNode &node, const ProfilePlanner &planner)
+    {
+        uint32_t state = mState.load(std::memory_order_acquire);
+        if (state == REQUESTED || state == PLANNING)
+            return false;
+
+        if (state == READY && mTag == tag && mSeq == seq && sameNode(mNode, node))
+            return false;
+
+        mTag = tag;
+        mSeq = seq;
+        mNode = node;
+        static_cast<ProfilePlanner &>(mPlanner) = planner;
+
+        mState.store(REQUESTED, std::memory_order_release);
+        return true;
+    }
+
+    bool PlanSlot::process(void)
+    {
+        uint32_t expected = REQUESTED;
+        if (!mState.compare_exchange_strong(expected, PLANNING, std::memory_order_acq_rel))
+            return false;
+
+        // 快进到当前节点的最后一个采样，最后一段只需执行一到两次
+        ProfilePlanner::ProfilePlannerData &data = mPlanner.data;
+        if (data.current_segment < data.number_segment)
+        {
+            uint32_t last = data.number_segment - 1;
+            if (data.current_segment < last)
+            {
+                data.current_segment = last;
+                data.current_tick = 0;
+            }
+
+            if (data.current_tick < data.segments[last].tick)
+                data.current_tick = data.segments[last].tick;
+
+            while (!mPlanner.execute())
+                ;
+        }
+
+        if (mPlanner.input_info.end_vel != 0.0)
+        { // 不停止地结束时与同步规划一致，从终点状态开始
+            mEntryPos = mPlanner.input_info.end_position;
+            mEntryVel = mPlanner.input_info.end_vel;
+            mEntryAcc = 0;
+        }
+        else
+        {
+            mEntryPos = data.position;
+            mEntryVel = data.velocity;
+            mEntryAcc = data.acceleration;
+        }
+        mEntryRemain = data.t_remain;
+
+        mResult = mPlanner.plan(&mNode, mEntryPos, mEntryVel, mEntryAcc);
+
+        mState.store(READY, std::memory_order_release);
+        return true;
+    }
+
+    bool PlanSlot::take(const void *tag, const ProfileNode &node, ProfilePlanner &planner,
+                        double startPos, double startVel, double startAcc)
+    {
+        if (mState.load(std::memory_order_acquire) != READY)
+            return false;
+
+        // 规划结果只取决于这些输入，全部一致时与同步规划逐位相同
+        bool hit = mTag == tag && mResult && sameNode(mNode, node) && mEntryPos == startPos &&
+                   mEntryVel == startVel && mEntryAcc == startAcc && mEntryRemain == planner.data.t_remain &&
+                   mPlanner.frequency == planner.frequency &&
+                   planner.data.current_segment >= planner.data.number_segment;
+
+        if (hit)
+        {
+            planner.data_backup = planner.data;
+            planner.data = mPlanner.data;
+            planner.input_info = mPlanner.input_info;
+        }
+
+        mState.store(IDLE, std::memory_order_release);
+        return hit;
+    }
+
+    void PlanSlot::setCache(PlanCache *cache)
+    {
+        mPlanner.setCache(cache);
+    }
+
+    class PlanWorker::PlanWorkerImpl
+    {
+    public:
+        std::thread mThread;
+        int32_t mCpu = -1;
+
+        std::vector<PlanSlot *> mSlots;
+        std::mutex mSlotMutex;
+
+        std::atomic<uint32_t> mRequests{0};
+        std::atomic<bool> mExit{false};
+        std::mutex mMutex;
+        std::condition_variable mCond;
+
+    public:
+        void workerLoop(void);
+        bool applyAffinity(void);
+    };
+
+    void PlanWorker::PlanWorkerImpl::workerLoop(void)
+    {
+        uint32_t seen = mRequests.load(std::memory_order_acquire);
+
+        while (!mExit.load(std::memory_order_acquire))
+        {
+            bool busy = false;
+            {
+                std::lock_guard<std::mutex> lock(mSlotMutex);
+                for (PlanSlot *slot : mSlots)
+                    busy |= slot->process();
+            }
+
+            if (busy)
+                continue;
+
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCond.wait_for(lock, std::chrono::microseconds(URANUS_PLANWORKER_IDLE_US), [this, seen]
+                           { return mRequests.load(std::memory_order_acquire) != seen ||
+                                    mExit.load(std::memory_order_acquire); });
+            seen = mRequests.load(std::memory_order_acquire);
+        }
+    }
+
+    bool PlanWorker::PlanWorkerImpl::applyAffinity(void)
+    {
+        if (mCpu < 0 || !mThread.joinable())
+            return true;
+
+#if defined(_WIN32)
+        return SetThreadAffinityMask((HANDLE)mThread.native_handle(), (DWORD_PTR)1 << mCpu) != 0;
+#elif defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(mCpu, &set);
+        return pthread_setaffinity_np(mThread.native_handle(), sizeof(set), &set) == 0;
+#else
+        return false;
+#endif
+    }
+
+    PlanWorker::PlanWorker()
+    {
+        mImpl_ = new PlanWorkerImpl();
+    }
+
+    PlanWorker::~PlanWorker()
+    {
+        stop();
+        delete mImpl_;
+    }
+
+    bool PlanWorker::start(int32_t cpu)
+    {
+        stop();
+
+        mImpl_->mCpu = cpu;
+        mImpl_->mExit.store(false, std::memory_order_release);
+        mImpl_->mThread = std::thread(&PlanWorkerImpl::workerLoop, mImpl_);
+
+        return mImpl_->applyAffinity();
+    }
+
+    void PlanWorker::stop(void)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mImpl_->mMutex);
+            mImpl_->mExit.store(true, std::memory_order_release);
+        }
+        mImpl_->mCond.notify_all();
+
+        if (mImpl_->mThread.joinable())
+            mImpl_->mThread.join();
+    }
+
+    bool PlanWorker::isRunning(void) const
+    {
+        return mImpl_->mThread.joinable();
+    }
+
+    void PlanWorker::attach(PlanSlot *slot)
+    {
+        std::lock_guard<std::mutex> lock(mImpl_->mSlotMutex);
+        for (PlanSlot *one : mImpl_->mSlots)
+        {
+            if (one == slot)
+                return;
+        }
+
+        mImpl_->mSlots.push_back(slot);
+    }
+
+    void PlanWorker::detach(PlanSlot *slot)
+    {
+        std::lock_guard<std::mutex> lock(mImpl_->mSlotMutex);
+        for (size_t i = 0; i < mImpl_->mSlots.size(); ++i)
+        {
+            if (mImpl_->mSlots[i] == slot)
+            {
+                mImpl_->mSlots.erase(mImpl_->mSlots.begin() + i);
+                return;
+            }
+        }
+    }
+
+    void PlanWorker::notify(void)
+    {
+        // 周期线程中不加锁，丢失的唤醒由定时等待兜底
+        mImpl_->mRequests.fetch_add(1, std::memory_order_release);
+        mImpl_->mCond.notify_one();
+    }
+
+} // namespace Uranus
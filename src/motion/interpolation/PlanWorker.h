@@ -0,0 +1,124 @@
+/*
+ * PlanWorker.h
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#ifndef _URANUS_PLANWORKER_HPP_
+#define _URANUS_PLANWORKER_HPP_
+
+#include "ProfilesPlanner.h"
+
+#include <atomic>
+
+namespace Uranus
+{
+
+    /*
+     * 轴的预规划槽，周期线程与规划线程之间单生产者单消费者交接
+     * IDLE -> REQUESTED(周期线程提交) -> PLANNING -> READY(规划线程完成) -> IDLE(周期线程取走)
+     */
+    class PlanSlot
+    {
+    public:
+        enum State : uint32_t
+        {
+            IDLE = 0,
+            REQUESTED,
+            PLANNING,
+            READY,
+        };
+
+        PlanSlot();
+
+        /*
+         * 提交下一个节点的预规划，只能在周期线程中调用
+         * tag:节点标识，seq:当前规划的序号，planner:正在执行当前节点的规划器
+         * 槽正忙或已有相同请求时返回false
+         */
+        bool submit(const void *tag, uint32_t seq, const ProfileNode &node, const ProfilePlanner &planner);
+
+        /*
+         * 节点开始执行时取走预规划结果，只能在周期线程中调用
+         * 规划器与起始状态和预规划时完全一致才写入planner并返回true，否则需同步规划
+         */
+        bool take(const void *tag, const ProfileNode &node, ProfilePlanner &planner,
+                  double startPos, double startVel, double startAcc);
+
+        // 执行一次规划，由规划线程调用
+        bool process(void);
+
+        // 设定预规划使用的路径缓存，只能在登记到规划线程之前调用
+        void setCache(PlanCache *cache);
+
+        State state(void) const;
+
+    private:
+        static bool sameNode(const ProfileNode &a, const ProfileNode &b);
+
+    private:
+        std::atomic<uint32_t> mState{IDLE};
+        const void *mTag = nullptr;
+        uint32_t mSeq = 0;
+        ProfileNode mNode;
+        ProfilesPlanner mPlanner; // 输入为当前节点的规划器，输出为下一节点的规划结果
+        bool mResult = false;
+
+        // 下一节点的起始状态，即上一节点的最后一个采样或不停止结束时的终点
+        double mEntryPos = 0;
+        double mEntryVel = 0;
+        double mEntryAcc = 0;
+        double mEntryRemain = 0;
+    };
+
+    /*
+     * 后台规划线程，在节点开始执行前规划缓冲的节点，
+     * 使周期线程在节点的第一个周期只需拷贝规划结果
+     */
+    class PlanWorker
+    {
+    public:
+        PlanWorker();
+        ~PlanWorker();
+
+        // 启动规划线程，cpu小于0时不绑定
+        bool start(int32_t cpu = -1);
+
+        // 停止规划线程，未完成的请求保留到下次启动
+        void stop(void);
+
+        bool isRunning(void) const;
+
+        // 登记/注销轴的预规划槽，注销返回后规划线程不再访问该槽
+        void attach(PlanSlot *slot);
+        void detach(PlanSlot *slot);
+
+        // 唤醒规划线程，在周期线程提交请求后调用
+        void notify(void);
+
+    private:
+        class PlanWorkerImpl;
+        PlanWorkerImpl *mImpl_;
+    };
+
+}
+
+#endif /** _URANUS_PLANWORKER_HPP_ **/
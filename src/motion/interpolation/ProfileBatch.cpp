@@ -0,0 +1,361 @@
+/*
+ * ProfileBatch.cpp
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#include "ProfileBatch.h"
+
+#include <string.h>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define URANUS_PROFILEBATCH_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace Uranus
+{
+
+// 向量宽度(double)，数组按此对齐填充
+#define URANUS_PROFILEBATCH_WIDTH 4
+
+    typedef ProfilePlanner::Segment Segment;
+
+    class ProfileBatch::ProfileBatchImpl
+    {
+    public:
+        struct Lane
+        {
+            Segment mSegments[MAX_ROUTE_SEGMENT_NUM];
+            uint32_t mNumber = 0;
+            uint32_t mCurrent = 0;
+            bool mTrapezoid = true;
+        };
+
+        uint32_t mLaneNum = 0;
+        uint32_t mPadNum = 0;
+        std::vector<Lane> mLanes;
+
+        // 当前段参数(SoA)
+        std::vector<double> mStartPos, mStartVel, mAcc, mJerk, mEndPos;
+        std::vector<double> mTick, mCurTick, mMagic, mFreq, mEndVel, mDone;
+
+        // 输出
+        std::vector<double> mPos, mVel, mAccOut;
+
+        // 需要切换段的轴
+        std::vector<uint32_t> mSwitch;
+
+        // 轴最近一次切换段时的步数
+        std::vector<uint64_t> mSwitchStep;
+        uint64_t mSteps = 0;
+
+    public:
+        void loadSegment(uint32_t lane);
+        uint32_t stepPortable(void);
+#ifdef URANUS_PROFILEBATCH_AVX2
+        __attribute__((target("avx2"))) uint32_t stepAvx2(void);
+#endif
+    };
+
+    void ProfileBatch::ProfileBatchImpl::loadSegment(uint32_t lane)
+    {
+        Lane &l = mLanes[lane];
+        if (l.mCurrent >= l.mNumber)
+        {
+            mDone[lane] = 1.0;
+            return;
+        }
+
+        const Segment &seg = l.mSegments[l.mCurrent];
+        mDone[lane] = 0.0;
+        mStartPos[lane] = seg.start_position;
+        mStartVel[lane] = seg.start_vel;
+        mAcc[lane] = seg.acc;
+        mJerk[lane] = seg.jerk;
+        mEndPos[lane] = seg.end_position;
+        mTick[lane] = seg.tick;
+        mMagic[lane] = seg.magic_flags ? 1.0 : 0.0;
+    }
+
+    // 与ProfilePlanner::execute()相同的计算顺序
+    uint32_t ProfileBatch::ProfileBatchImpl::stepPortable(void)
+    {
+        uint32_t num = 0;
+        for (uint32_t i = 0; i < mLaneNum; ++i)
+        {
+            if (mDone[i] != 0.0)
+            {
+                mVel[i] = mEndVel[i];
+                mPos[i] += mVel[i] / mFreq[i];
+                mAccOut[i] = 0.0;
+                continue;
+            }
+
+            double t = mCurTick[i] / mFreq[i];
+            double acc_2 = mAcc[i] * t / 2;
+            double jerk_6 = mJerk[i] * t * t / 6;
+            double vel = mStartVel[i] + acc_2 + jerk_6;
+
+            mPos[i] = mStartPos[i] + vel * t;
+            mVel[i] = vel + (acc_2 + 2 * jerk_6);
+            mAccOut[i] = mAcc[i] + mJerk[i] * t;
+
+            if (mCurTick[i] == mTick[i] && mMagic[i] == 0.0)
+            {
+                mSwitch[num++] = i;
+            }
+            else if (mCurTick[i] > mTick[i])
+            {
+                mPos[i] = mEndPos[i];
+                if (mMagic[i] != 0.0)
+                    mVel[i] = mAccOut[i] = 0.0;
+                mSwitch[num++] = i;
+            }
+            else
+            {
+                mCurTick[i] += 1.0;
+            }
+        }
+
+        return num;
+    }
+
+#ifdef URANUS_PROFILEBATCH_AVX2
+    __attribute__((target("avx2"))) uint32_t ProfileBatch::ProfileBatchImpl::stepAvx2(void)
+    {
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d one = _mm256_set1_pd(1.0);
+        const __m256d two = _mm256_set1_pd(2.0);
+        const __m256d six = _mm256_set1_pd(6.0);
+
+        uint32_t num = 0;
+        for (uint32_t i = 0; i < mPadNum; i += URANUS_PROFILEBATCH_WIDTH)
+        {
+            __m256d cur = _mm256_loadu_pd(&mCurTick[i]);
+            __m256d tick = _mm256_loadu_pd(&mTick[i]);
+            __m256d freq = _mm256_loadu_pd(&mFreq[i]);
+            __m256d acc = _mm256_loadu_pd(&mAcc[i]);
+            __m256d jerk = _mm256_loadu_pd(&mJerk[i]);
+            __m256d done = _mm256_cmp_pd(_mm256_loadu_pd(&mDone[i]), zero, _CMP_NEQ_OQ);
+            __m256d magic = _mm256_cmp_pd(_mm256_loadu_pd(&mMagic[i]), zero, _CMP_NEQ_OQ);
+
+            // 段内计算
+            __m256d t = _mm256_div_pd(cur, freq);
+            __m256d acc_2 = _mm256_div_pd(_mm256_mul_pd(acc, t), two);
+            __m256d jerk_6 = _mm256_div_pd(_mm256_mul_pd(_mm256_mul_pd(jerk, t), t), six);
+            __m256d vel = _mm256_add_pd(_mm256_add_pd(_mm256_loadu_pd(&mStartVel[i]), acc_2), jerk_6);
+            __m256d pos = _mm256_add_pd(_mm256_loadu_pd(&mStartPos[i]), _mm256_mul_pd(vel, t));
+            vel = _mm256_add_pd(vel, _mm256_add_pd(acc_2, _mm256_mul_pd(two, jerk_6)));
+            __m256d accOut = _mm256_add_pd(acc, _mm256_mul_pd(jerk, t));
+
+            // 超出段末尾：位置取段终点，末段速度与加速度清零
+            __m256d over = _mm256_andnot_pd(done, _mm256_cmp_pd(cur, tick, _CMP_GT_OQ));
+            __m256d stop = _mm256_and_pd(over, magic);
+            pos = _mm256_blendv_pd(pos, _mm256_loadu_pd(&mEndPos[i]), over);
+            vel = _mm256_blendv_pd(vel, zero, stop);
+            accOut = _mm256_blendv_pd(accOut, zero, stop);
+
+            // 已完成：按终速度匀速
+            __m256d endVel = _mm256_loadu_pd(&mEndVel[i]);
+            __m256d donePos = _mm256_add_pd(_mm256_loadu_pd(&mPos[i]), _mm256_div_pd(endVel, freq));
+            pos = _mm256_blendv_pd(pos, donePos, done);
+            vel = _mm256_blendv_pd(vel, endVel, done);
+            accOut = _mm256_blendv_pd(accOut, zero, done);
+
+            _mm256_storeu_pd(&mPos[i], pos);
+            _mm256_storeu_pd(&mVel[i], vel);
+            _mm256_storeu_pd(&mAccOut[i], accOut);
+
+            __m256d reach = _mm256_andnot_pd(magic, _mm256_cmp_pd(cur, tick, _CMP_EQ_OQ));
+            __m256d next = _mm256_andnot_pd(done, _mm256_or_pd(reach, over));
+            _mm256_storeu_pd(&mCurTick[i], _mm256_add_pd(cur, _mm256_andnot_pd(next, one)));
+
+            int mask = _mm256_movemask_pd(next);
+            while (mask)
+            {
+                int bit = __builtin_ctz(mask);
+                mask &= mask - 1;
+                if (i + bit < mLaneNum)
+                    mSwitch[num++] = i + bit;
+            }
+        }
+
+        return num;
+    }
+#endif
+
+    ProfileBatch::ProfileBatch(uint32_t laneNum)
+    {
+        mImpl_ = new ProfileBatchImpl();
+        mImpl_->mLaneNum = laneNum;
+        mImpl_->mPadNum = (laneNum + URANUS_PROFILEBATCH_WIDTH - 1) / URANUS_PROFILEBATCH_WIDTH * URANUS_PROFILEBATCH_WIDTH;
+        mImpl_->mLanes.resize(laneNum);
+
+        uint32_t pad = mImpl_->mPadNum;
+        for (std::vector<double> *array :
+             {&mImpl_->mStartPos, &mImpl_->mStartVel, &mImpl_->mAcc, &mImpl_->mJerk, &mImpl_->mEndPos, &mImpl_->mTick,
+              &mImpl_->mCurTick, &mImpl_->mMagic, &mImpl_->mEndVel, &mImpl_->mPos, &mImpl_->mVel, &mImpl_->mAccOut})
+            array->assign(pad, 0.0);
+        mImpl_->mFreq.assign(pad, 1000.0);
+        mImpl_->mDone.assign(pad, 1.0);
+        mImpl_->mSwitch.resize(pad);
+        mImpl_->mSwitchStep.assign(laneNum, 0);
+    }
+
+    ProfileBatch::~ProfileBatch()
+    {
+        delete mImpl_;
+    }
+
+    uint32_t ProfileBatch::laneNum(void) const
+    {
+        return mImpl_->mLaneNum;
+    }
+
+    void ProfileBatch::load(uint32_t lane, const ProfilePlanner &planner)
+    {
+        if (lane >= mImpl_->mLaneNum)
+            return;
+
+        const ProfilePlanner::ProfilePlannerData &data = planner.data;
+        ProfileBatchImpl::Lane &l = mImpl_->mLanes[lane];
+
+        memcpy(l.mSegments, data.segments, sizeof(l.mSegments));
+        l.mNumber = data.number_segment;
+        l.mCurrent = data.current_segment;
+        l.mTrapezoid = (data.jerk == 0.0);
+
+        mImpl_->mCurTick[lane] = data.current_tick;
+        mImpl_->mFreq[lane] = data.frequency;
+        mImpl_->mEndVel[lane] = planner.input_info.end_vel;
+        mImpl_->mPos[lane] = data.position;
+        mImpl_->mVel[lane] = data.velocity;
+        mImpl_->mAccOut[lane] = 0.0;
+        mImpl_->loadSegment(lane);
+    }
+
+    void ProfileBatch::clear(uint32_t lane)
+    {
+        if (lane >= mImpl_->mLaneNum)
+            return;
+
+        mImpl_->mLanes[lane].mNumber = 0;
+        mImpl_->mLanes[lane].mCurrent = 0;
+        mImpl_->mEndVel[lane] = 0.0;
+        mImpl_->mVel[lane] = 0.0;
+        mImpl_->mAccOut[lane] = 0.0;
+        mImpl_->mDone[lane] = 1.0;
+    }
+
+    void ProfileBatch::step(void)
+    {
+        uint32_t num;
+#ifdef URANUS_PROFILEBATCH_AVX2
+        if (simdEnabled())
+            num = mImpl_->stepAvx2();
+        else
+#endif
+            num = mImpl_->stepPortable();
+        ++mImpl_->mSteps;
+
+        // 段切换只处理掩码中的轴
+        for (uint32_t k = 0; k < num; ++k)
+        {
+            uint32_t lane = mImpl_->mSwitch[k];
+            ProfileBatchImpl::Lane &l = mImpl_->mLanes[lane];
+
+            mImpl_->mSwitchStep[lane] = mImpl_->mSteps;
+            mImpl_->mCurTick[lane] = 0.0;
+            ++l.mCurrent;
+            mImpl_->loadSegment(lane);
+
+            // 与getAcceleration()一致：完成后为0，梯形规划取新段加速度
+            if (mImpl_->mDone[lane] != 0.0)
+                mImpl_->mAccOut[lane] = 0.0;
+            else if (l.mTrapezoid)
+                mImpl_->mAccOut[lane] = mImpl_->mAcc[lane];
+        }
+    }
+
+    uint64_t ProfileBatch::steps(void) const
+    {
+        return mImpl_->mSteps;
+    }
+
+    bool ProfileBatch::store(uint32_t lane, ProfilePlanner &planner, bool &isDone) const
+    {
+        if (lane >= mImpl_->mLaneNum || mImpl_->mSwitchStep[lane] == mImpl_->mSteps)
+            return false;
+
+        ProfilePlanner::ProfilePlannerData &data = planner.data;
+        ++data.elapsed_tick;
+        data.position = mImpl_->mPos[lane];
+        data.velocity = mImpl_->mVel[lane];
+
+        if (mImpl_->mDone[lane] != 0.0)
+        { // 规划已完成，按终速度匀速
+            planner.input_info.end_position = data.position;
+            data.t_remain = 1.0 / data.frequency;
+            isDone = true;
+        }
+        else
+        { // 段内前进一个tick，输出的加速度即段内加速度
+            data.acceleration = mImpl_->mAccOut[lane];
+            ++data.current_tick;
+            isDone = false;
+        }
+
+        return true;
+    }
+
+    bool ProfileBatch::done(uint32_t lane) const
+    {
+        return lane >= mImpl_->mLaneNum || mImpl_->mDone[lane] != 0.0;
+    }
+
+    const double *ProfileBatch::position(void) const
+    {
+        return mImpl_->mPos.data();
+    }
+
+    const double *ProfileBatch::velocity(void) const
+    {
+        return mImpl_->mVel.data();
+    }
+
+    const double *ProfileBatch::acceleration(void) const
+    {
+        return mImpl_->mAccOut.data();
+    }
+
+    bool ProfileBatch::simdEnabled(void)
+    {
+#ifdef URANUS_PROFILEBATCH_AVX2
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+}
@@ -0,0 +1,81 @@
+/*
+ * ProfileBatch.h
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ */
+
+#ifndef _URANUS_PROFILEBATCH_HPP_
+#define _URANUS_PROFILEBATCH_HPP_
+
+#include "ProfilePlanner.h"
+
+namespace Uranus
+{
+
+    /*
+     * 多轴批量轨迹步进：各轴当前段参数按SoA存放，每个tick一次向量化计算所有轴的位置/速度/加速度，
+     * 段切换按掩码只处理需要切换的轴。每个轴的结果与对应ProfilePlanner::execute()逐tick一致
+     */
+    class ProfileBatch
+    {
+    public:
+        explicit ProfileBatch(uint32_t laneNum);
+        ~ProfileBatch();
+
+        uint32_t laneNum(void) const;
+
+        // 载入规划器的当前状态，之后由step()代替planner.execute()
+        void load(uint32_t lane, const ProfilePlanner &planner);
+
+        // 清空轴，轴保持当前位置
+        void clear(uint32_t lane);
+
+        // 所有轴前进一个tick
+        void step(void);
+
+        // 已执行的step()次数
+        uint64_t steps(void) const;
+
+        /*
+         * 将上一次step()的结果写回规划器，与对该规划器调用execute()的结果逐位相同
+         * 规划器须处于load()或上一次store()之后的状态，isDone返回execute()的返回值
+         * 轴在上一次step()中切换了段时不写回并返回false，由调用者执行planner.execute()
+         */
+        bool store(uint32_t lane, ProfilePlanner &planner, bool &isDone) const;
+
+        // 轴的规划是否已执行完成
+        bool done(uint32_t lane) const;
+
+        const double *position(void) const;
+        const double *velocity(void) const;
+        const double *acceleration(void) const;
+
+        // 是否使用AVX2计算
+        static bool simdEnabled(void);
+
+    private:
+        class ProfileBatchImpl;
+        ProfileBatchImpl *mImpl_;
+    };
+
+}
+
+#endif /** _URANUS_PROFILEBATCH_HPP_ **/
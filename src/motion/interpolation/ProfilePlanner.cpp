@@ -26,6 +26,7 @@
 
 #include "ProfilePlanner.h"
 #include "MathUtils.h"
+#include "PlanCache.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -41,6 +42,12 @@ typedef ProfilePlanner::ProfilePlannerData ProfilePlannerData;
 static int route_calculate(Segment *segments, double shift, double start_vel, double vel, double acc, double dec,
                            double &end_vel);
 
+static int route_calculate_jerk(Segment *segments, double shift, double start_vel, double start_acc, double vel,
+                                double acc, double dec, double jerk, double end_vel);
+
+static double cal_shift_jerk(double start_vel, double start_acc, double vel, double end_vel, double acc, double dec,
+                             double jerk);
+
 static bool route_param_pre_process(double &vel, double &acc, double &dec, double &end_vel);
 
 static int route_verify_and_shift(Segment *segments, double end_vel, double pos_offset);
@@ -51,6 +58,8 @@ static void route_discretization(Segment *segments, int length, uint32_t frequen
 
 static int tiny_segment_merge(Segment *segments, int length, uint32_t frequency, int32_t &new_start_tick);
 
+static void route_timing(Segment *segments, int length, uint32_t frequency);
+
 static double cal_shift(double start_vel, double end_vel, double acc, double *t);
 
 static inline bool is_acc_neg(double start_vel, double end_vel);
@@ -64,9 +73,10 @@ void print_all(Segment *segments, int num)
                "end_position=%lf, "
                "start_vel=%lf, "
                "acc=%lf, "
+               "jerk=%lf, "
                "t=%lf\n",
                i, segments[i].start_position, segments[i].end_position, segments[i].start_vel, segments[i].acc,
-               segments[i].t);
+               segments[i].jerk, segments[i].t);
     }
 }
 
@@ -110,11 +120,15 @@ double ProfilePlanner::limitStartVel(double dist, double start_vel, double end_v
     return start_vel;
 }
 
-double ProfilePlanner::calculateDist(double start_vel, double end_vel, double acc, double dec)
+double ProfilePlanner::calculateDist(double start_vel, double end_vel, double acc, double dec, double jerk,
+                                     double start_acc)
 {
     acc = fabs(acc);
     dec = fabs(dec);
 
+    if (jerk > 0.0)
+        return cal_shift_jerk(start_vel, start_acc, end_vel, end_vel, acc, dec, jerk);
+
     if (isOpposite(start_vel, end_vel))
         return (start_vel * fabs(start_vel) / dec + end_vel * fabs(end_vel) / acc) * 0.5;
     else
@@ -125,12 +139,12 @@ double ProfilePlanner::calculateDist(double start_vel, double end_vel, double ac
 }
 
 bool ProfilePlanner::plan(double start_position, double end_position, double start_vel, double vel, double end_vel,
-                          double acc, double dec)
+                          double acc, double dec, double start_acc, double jerk, PlanCache *cache)
 {
     double shift;
     int route_calculate_result;
 
-    if (__iseq(start_position, end_position) && __iseq(start_vel, end_vel))
+    if (__iseq(start_position, end_position) && __iseq(start_vel, end_vel) && (jerk <= 0.0 || __iszero(start_acc)))
     {
         data.number_segment = 0;
         goto EXIT;
@@ -151,7 +165,29 @@ bool ProfilePlanner::plan(double start_position, double end_position, double sta
     memset(data.segments, 0, sizeof(Segment) * MAX_ROUTE_SEGMENT_NUM);
     shift = end_position - start_position;
 
-    route_calculate_result = route_calculate(data.segments, shift, start_vel, vel, acc, dec, end_vel);
+    // 路径段在平移到起点之前只取决于相对位移与速度参数，可以复用
+    PlanCache::Key key;
+    key.mShift = shift;
+    key.mStartVel = start_vel;
+    key.mStartAcc = (jerk > 0.0) ? start_acc : 0.0;
+    key.mVel = vel;
+    key.mEndVel = end_vel;
+    key.mAcc = acc;
+    key.mDec = dec;
+    key.mJerk = (jerk > 0.0) ? jerk : 0.0;
+
+    // 行程不足时路径计算会修正end_vel，命中时一并恢复
+    if (!cache || !cache->find(key, data.segments, route_calculate_result, end_vel))
+    {
+        if (jerk > 0.0)
+            route_calculate_result =
+                route_calculate_jerk(data.segments, shift, start_vel, start_acc, vel, acc, dec, jerk, end_vel);
+        else
+            route_calculate_result = route_calculate(data.segments, shift, start_vel, vel, acc, dec, end_vel);
+
+        if (cache)
+            cache->insert(key, data.segments, route_calculate_result, end_vel);
+    }
 
     switch (route_calculate_result)
     {
@@ -178,14 +214,19 @@ bool ProfilePlanner::plan(double start_position, double end_position, double sta
 
     data.number_segment = tiny_segment_merge(data.segments, data.number_segment, frequency, data.current_tick);
 
+    route_timing(data.segments, data.number_segment, frequency);
+
 #ifdef MC_DEBUG
     print_all(data.segments, data.number_segment);
 #endif
 
 EXIT:
     data.frequency = frequency;
+    data.elapsed_tick = 0;
     data.position = start_position;
     data.velocity = start_vel;
+    data.acceleration = start_acc;
+    data.jerk = (jerk > 0.0) ? jerk : 0.0;
 
     input_info.start_position = start_position;
     input_info.end_position = end_position;
@@ -203,6 +244,8 @@ EXIT:
 
 bool ProfilePlanner::execute(void)
 {
+    ++data.elapsed_tick;
+
     if (data.current_segment >= data.number_segment)
     {
         data.velocity = input_info.end_vel;
@@ -212,27 +255,31 @@ bool ProfilePlanner::execute(void)
         return true;
     }
 
+    const Segment *segment = &data.segments[data.current_segment];
     double t = (double)(data.current_tick) / data.frequency;
 
-    double acc_2 = data.segments[data.current_segment].acc * t / 2;
+    double acc_2 = segment->acc * t / 2;
+    double jerk_6 = segment->jerk * t * t / 6;
 
-    data.velocity = data.segments[data.current_segment].start_vel + acc_2;
-    data.position = data.segments[data.current_segment].start_position + data.velocity * t;
-    data.velocity += acc_2;
+    // jerk为0时与梯形规划的计算顺序一致，结果逐位相同
+    data.velocity = segment->start_vel + acc_2 + jerk_6;
+    data.position = segment->start_position + data.velocity * t;
+    data.velocity += acc_2 + 2 * jerk_6;
+    data.acceleration = segment->acc + segment->jerk * t;
 
-    if (data.current_tick == data.segments[data.current_segment].tick &&
-        !data.segments[data.current_segment].magic_flags)
+    if (data.current_tick == segment->tick && !segment->magic_flags)
     {
         goto SEGMENT_SUCCESS;
     }
-    else if (data.current_tick > data.segments[data.current_segment].tick)
+    else if (data.current_tick > segment->tick)
     {
-        data.position = data.segments[data.current_segment].end_position;
+        data.position = segment->end_position;
 
-        if (data.segments[data.current_segment].magic_flags)
+        if (segment->magic_flags)
         {
             data.t_remain = 0.0;
             data.velocity = 0;
+            data.acceleration = 0;
         }
 
         goto SEGMENT_SUCCESS;
@@ -252,7 +299,7 @@ SEGMENT_SUCCESS:
 
 int ProfilePlanner::readStatus(void)
 {
-    if ((data.current_segment >= data.number_segment) || (data.segments[data.current_segment].acc == 0.0))
+    if ((data.current_segment >= data.number_segment) || (segmentAcceleration() == 0.0))
     {
         if (data.velocity == 0.0)
             return 0;
@@ -260,12 +307,92 @@ int ProfilePlanner::readStatus(void)
             return 1;
     }
 
-    if ((data.segments[data.current_segment].acc > 0.0) != (data.velocity > 0.0))
+    if ((segmentAcceleration() > 0.0) != (data.velocity > 0.0))
         return 3;
     else
         return 2;
 }
 
+uint32_t ProfilePlanner::findSegment(double t, uint32_t from) const
+{
+    // 第一个结束时刻不早于t的段
+    uint32_t lo = from, hi = data.number_segment;
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2;
+        if (data.segments[mid].start_t + data.segments[mid].t < t)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+void ProfilePlanner::evaluateSegment(uint32_t index, double t, State &state) const
+{
+    if (index >= data.number_segment)
+    { // 规划结束后按终速度匀速
+        const Segment *last = &data.segments[data.number_segment - 1];
+        double t_end = last->start_t + last->t;
+        double end_vel = last->magic_flags ? 0.0 : input_info.end_vel;
+
+        state.position = last->end_position + end_vel * (t - t_end);
+        state.velocity = end_vel;
+        state.acceleration = 0.0;
+        return;
+    }
+
+    // 段起点已平移到首个采样点，t可能略早于段起点
+    const Segment *segment = &data.segments[index];
+    double local = t - segment->start_t;
+    double local2 = local * local;
+
+    state.position = segment->start_position + segment->start_vel * local + segment->acc * local2 / 2 +
+                     segment->jerk * local2 * local / 6;
+    state.velocity = segment->start_vel + segment->acc * local + segment->jerk * local2 / 2;
+    state.acceleration = segment->acc + segment->jerk * local;
+}
+
+bool ProfilePlanner::evaluate(double t, State &state) const
+{
+    if (!data.number_segment)
+        return false;
+
+    evaluateSegment(findSegment(t, 0), t, state);
+    return true;
+}
+
+bool ProfilePlanner::evaluateBatch(const double *times, State *states, uint32_t num) const
+{
+    if (!data.number_segment)
+        return false;
+
+    uint32_t index = 0;
+    double prev = -INFINITY;
+    for (uint32_t i = 0; i < num; ++i)
+    {
+        double t = times[i];
+        if (t < prev)
+            index = findSegment(t, 0);
+        else
+        { // 时间递增时顺序推进
+            while (index < data.number_segment && data.segments[index].start_t + data.segments[index].t < t)
+                ++index;
+        }
+
+        evaluateSegment(index, t, states[i]);
+        prev = t;
+    }
+
+    return true;
+}
+
+double ProfilePlanner::elapsedTime(void) const
+{
+    return (double)(data.elapsed_tick - 1) / data.frequency;
+}
+
 double ProfilePlanner::getPosition(void)
 {
     return data.position;
@@ -284,10 +411,18 @@ double ProfilePlanner::getAcceleration(void)
     }
     else
     {
-        return data.segments[data.current_segment].acc;
+        return segmentAcceleration();
     }
 }
 
+double ProfilePlanner::segmentAcceleration(void)
+{
+    // S曲线返回最近一次输出点的加速度，梯形规划保持按段返回
+    if (data.jerk == 0.0)
+        return data.segments[data.current_segment].acc;
+
+    return data.acceleration;
+}
 double ProfilePlanner::getStartPosition(void)
 {
     return input_info.start_position;
@@ -365,17 +500,25 @@ static int route_calculate(Segment *segments, double shift, double start_vel, do
 
     /**
      * if shift and start_vel are not at the same direction,
+     * or it is too late to stop at the end (overshoot),
      * dec to 0 in advance.
      **/
-    if (isOpposite(shift_tmp, start_vel))
+    double t_stop;
+    double shift_stop = cal_shift(start_vel, 0.0, dec, &t_stop);
+    bool overshoot = !end_vel && __isne(shift_stop, shift) && (fabs(shift_stop) > fabs(shift));
+
+    if (isOpposite(shift_tmp, start_vel) || overshoot)
     {
-        double t;
-        shift_pre = cal_shift(start_vel, 0.0, dec, &t);
+        shift_pre = shift_stop;
 
-        set_route_segment(segments, 0.0, shift_pre, start_vel, (shift_pre < 0) ? dec : -dec, t);
+        set_route_segment(segments, 0.0, shift_pre, start_vel, (shift_pre < 0) ? dec : -dec, t_stop);
 
         start_vel = 0.0;
         shift_tmp -= shift_pre;
+
+        // 越过终点后反向返回
+        if (overshoot)
+            vel = (shift_tmp < 0.0) ? -fabs(vel) : fabs(vel);
     }
     else
     {
@@ -492,6 +635,160 @@ static int route_calculate(Segment *segments, double shift, double start_vel, do
     return result;
 }
 
+#define JERK_PHASE_NUM 3
+#define JERK_BISECTION_MAX 100
+
+typedef struct
+{
+    double t;
+    double jerk;
+} JerkPhase;
+
+/**
+ * change velocity from (start_vel, start_acc) to (end_vel, 0) with
+ * |acc| <= acc_limit (unless start_acc is already beyond) and |jerk| == jerk,
+ * phases: jerk up, constant acc, jerk down
+ **/
+static void vel_change_jerk(JerkPhase *phases, double start_vel, double start_acc, double end_vel, double acc_limit,
+                            double jerk)
+{
+    // velocity reached if acc is brought to 0 immediately
+    double stop_vel = start_vel + start_acc * fabs(start_acc) / (2 * jerk);
+    double dir = (end_vel >= stop_vel) ? 1.0 : -1.0;
+
+    // mirror to the accelerating case
+    double v0 = start_vel * dir;
+    double a0 = start_acc * dir;
+    double dv = end_vel * dir - v0;
+
+    double ap;
+    if (a0 > acc_limit)
+        ap = acc_limit;
+    else
+        ap = fmin(acc_limit, sqrt(fmax((2 * jerk * dv + a0 * a0) / 2, 0.0)));
+
+    double t1 = fabs(ap - a0) / jerk;
+    double t3 = ap / jerk;
+    double dv1 = (a0 + ap) / 2 * t1;
+    double dv3 = ap * t3 / 2;
+    double t2 = (ap > 0.0) ? fmax((dv - dv1 - dv3) / ap, 0.0) : 0.0;
+
+    phases[0].t = t1;
+    phases[0].jerk = ((ap >= a0) ? jerk : -jerk) * dir;
+    phases[1].t = t2;
+    phases[1].jerk = 0.0;
+    phases[2].t = t3;
+    phases[2].jerk = -jerk * dir;
+}
+
+static double phases_shift(const JerkPhase *phases, int num, double vel, double acc)
+{
+    double shift = 0.0;
+    for (int i = 0; i < num; ++i)
+    {
+        double t = phases[i].t;
+        double j = phases[i].jerk;
+        shift += vel * t + acc * t * t / 2 + j * t * t * t / 6;
+        vel += acc * t + j * t * t / 2;
+        acc += j * t;
+    }
+
+    return shift;
+}
+
+static inline double limit_acc(double from_vel, double to_vel, double acc, double dec)
+{
+    return (fabs(from_vel) < fabs(to_vel)) ? acc : dec;
+}
+
+/**
+ * shift of: (start_vel, start_acc) -> (vel, 0) -> (end_vel, 0), without constant velocity part
+ **/
+static double cal_shift_jerk(double start_vel, double start_acc, double vel, double end_vel, double acc, double dec,
+                             double jerk)
+{
+    JerkPhase phases[JERK_PHASE_NUM];
+    double shift;
+
+    vel_change_jerk(phases, start_vel, start_acc, vel, limit_acc(start_vel, vel, acc, dec), jerk);
+    shift = phases_shift(phases, JERK_PHASE_NUM, start_vel, start_acc);
+
+    vel_change_jerk(phases, vel, 0.0, end_vel, limit_acc(vel, end_vel, acc, dec), jerk);
+    shift += phases_shift(phases, JERK_PHASE_NUM, vel, 0.0);
+
+    return shift;
+}
+
+/**
+ * 7 segments: jerk/acc/jerk to the cruise velocity, cruise, jerk/acc/jerk to end_vel.
+ * the shift without cruise is monotonic in the cruise velocity, if the shift is too
+ * short for +-vel the cruise velocity is found by bisection in [-vel, vel]
+ **/
+static int route_calculate_jerk(Segment *segments, double shift, double start_vel, double start_acc, double vel,
+                                double acc, double dec, double jerk, double end_vel)
+{
+    double v_uni, t_uni = 0.0;
+    double s_pos = cal_shift_jerk(start_vel, start_acc, vel, end_vel, acc, dec, jerk);
+    double s_neg = cal_shift_jerk(start_vel, start_acc, -vel, end_vel, acc, dec, jerk);
+
+    // 终点由起始状态推算时位移与s_pos只差舍入误差，按恰好到达处理，否则二分会落到反向的解
+    if ((shift >= s_pos || __iseq(shift, s_pos)) && vel > 0.0)
+    {
+        v_uni = vel;
+        t_uni = fmax(shift - s_pos, 0.0) / vel;
+    }
+    else if ((shift <= s_neg || __iseq(shift, s_neg)) && vel > 0.0)
+    {
+        v_uni = -vel;
+        t_uni = fmax(s_neg - shift, 0.0) / vel;
+    }
+    else
+    {
+        double lo = -vel, hi = vel;
+        for (int i = 0; i < JERK_BISECTION_MAX && hi - lo > __EPSILON * __EPSILON; ++i)
+        {
+            double mid = (lo + hi) / 2;
+            if (cal_shift_jerk(start_vel, start_acc, mid, end_vel, acc, dec, jerk) < shift)
+                lo = mid;
+            else
+                hi = mid;
+        }
+        v_uni = (lo + hi) / 2;
+    }
+
+    JerkPhase phases[JERK_PHASE_NUM * 2 + 1];
+    vel_change_jerk(phases, start_vel, start_acc, v_uni, limit_acc(start_vel, v_uni, acc, dec), jerk);
+    phases[JERK_PHASE_NUM].t = t_uni;
+    phases[JERK_PHASE_NUM].jerk = 0.0;
+    vel_change_jerk(phases + JERK_PHASE_NUM + 1, v_uni, 0.0, end_vel, limit_acc(v_uni, end_vel, acc, dec), jerk);
+
+    double pos = 0.0, v = start_vel, a = start_acc;
+    for (int i = 0; i < JERK_PHASE_NUM * 2 + 1; ++i)
+    {
+        double t = phases[i].t;
+        double j = phases[i].jerk;
+        double end_pos = pos + v * t + a * t * t / 2 + j * t * t * t / 6;
+
+        set_route_segment(segments + i, pos, end_pos, v, a, t);
+        segments[i].jerk = j;
+
+        pos = end_pos;
+        v += a * t + j * t * t / 2;
+        a += j * t;
+    }
+
+    for (int i = JERK_PHASE_NUM * 2; i >= 0; --i)
+    {
+        if (segments[i].t != 0.0)
+        {
+            segments[i].end_position = shift;
+            break;
+        }
+    }
+
+    return 0;
+}
+
 static int route_verify_and_shift(Segment *segments, double end_vel, double pos_offset)
 {
     int num = 0;
@@ -515,7 +812,7 @@ static int route_verify_and_shift(Segment *segments, double end_vel, double pos_
 
     segments[num - 1].magic_flags = (end_vel == 0.0) ? 0x1 : 0;
 
-    for (int i = num; i < 5; ++i)
+    for (int i = num; i < MAX_ROUTE_SEGMENT_NUM; ++i)
         memset(segments + i, 0, sizeof(Segment));
 
     return num;
@@ -526,7 +823,8 @@ static bool check_results(const Segment *segments, int length)
     for (int i = 0; i < length; ++i)
     {
         if (!std::isfinite(segments[i].start_position) || std::isnan(segments[i].end_position) ||
-            !std::isfinite(segments[i].start_vel) || !std::isfinite(segments[i].acc))
+            !std::isfinite(segments[i].start_vel) || !std::isfinite(segments[i].acc) ||
+            !std::isfinite(segments[i].jerk))
             return false;
     }
 
@@ -560,10 +858,12 @@ static void route_discretization(Segment *segments, int length, uint32_t frequen
         else
             each_t_remain[i + 1] = (ceil(t_freq) - t_freq) / frequency;
 
+        double r = each_t_remain[i];
         segments[i].start_position +=
-            segments[i].start_vel * each_t_remain[i] + segments[i].acc * each_t_remain[i] * each_t_remain[i] / 2;
+            segments[i].start_vel * r + segments[i].acc * r * r / 2 + segments[i].jerk * r * r * r / 6;
 
-        segments[i].start_vel += segments[i].acc * each_t_remain[i];
+        segments[i].start_vel += segments[i].acc * r + segments[i].jerk * r * r / 2;
+        segments[i].acc += segments[i].jerk * r;
         segments[i].tick = (int32_t)t_freq;
     }
 
@@ -596,6 +896,17 @@ static int tiny_segment_merge(Segment *segments, int length, uint32_t frequency,
     return length_new;
 }
 
+static void route_timing(Segment *segments, int length, uint32_t frequency)
+{
+    // 每段从tick 0执行到tick，下一段从下一个采样点开始
+    int32_t sample = 0;
+    for (int i = 0; i < length; ++i)
+    {
+        segments[i].start_t = (double)sample / frequency;
+        sample += (segments[i].tick >= 0 ? segments[i].tick : 0) + 1;
+    }
+}
+
 static double cal_shift(double start_vel, double end_vel, double acc, double *t)
 {
     if ((acc == 0) && __iseq(start_vel, end_vel))
@@ -32,7 +32,9 @@
 namespace Uranus
 {
 
-#define MAX_ROUTE_SEGMENT_NUM 5
+#define MAX_ROUTE_SEGMENT_NUM 7
+
+class PlanCache;
 
 class ProfilePlanner
 {
@@ -51,7 +53,9 @@ public:
         double end_position;
         double start_vel;
         double acc;
+        double jerk;
         double t;
+        double start_t;
         int32_t tick;
         int magic_flags;
     }Segment;
@@ -60,13 +64,23 @@ public:
     {
         double position;
         double velocity;
+        double acceleration;
+        double jerk;
         int32_t current_tick;
+        int32_t elapsed_tick;
         uint32_t frequency;
         uint32_t current_segment;
         uint32_t number_segment;
         double t_remain;
         Segment segments[MAX_ROUTE_SEGMENT_NUM];
     }ProfilePlannerData;
+
+    typedef struct
+    {
+        double position;
+        double velocity;
+        double acceleration;
+    }State;
     
 public:
     ProfilePlannerData data;
@@ -82,12 +96,25 @@ public:
     
     static double limitStartVel(double dist, double start_vel, double end_vel, double dec);
     
-    static double calculateDist(double start_vel, double end_vel, double acc, double dec);
+    /**
+     *  jerk > 0: distance of the jerk-limited profile starting with start_acc
+     **/
+    static double calculateDist(double start_vel, double end_vel, double acc, double dec,
+        double jerk = 0, double start_acc = 0);
 
+    /**
+     *  jerk == 0: trapezoidal profile, start_acc is ignored
+     *  jerk > 0: jerk-limited (S-curve) profile, starting with start_acc
+     *            and ending with zero acceleration
+     *  cache: reuse the route of an identical relative move, the result is
+     *         bit-identical to a fresh calculation
+     **/
     bool plan(
         double start_position, double end_position, 
         double start_vel, double vel, double end_vel,
-        double acc, double dec);
+        double acc, double dec,
+        double start_acc = 0, double jerk = 0,
+        PlanCache *cache = nullptr);
         
     bool execute(void);
     
@@ -99,6 +126,23 @@ public:
      *  3: decelerating
      **/
     int readStatus(void);
+
+    /**
+     *  closed-form evaluation of the planned profile, does not change the planner
+     *  t: seconds from the first execute() sample after plan()
+     *  return false if nothing is planned
+     **/
+    bool evaluate(double t, State &state) const;
+
+    /**
+     *  evaluate num samples, ascending times are evaluated without searching
+     **/
+    bool evaluateBatch(const double *times, State *states, uint32_t num) const;
+
+    /**
+     *  time of the last sample output by execute(), relative to plan()
+     **/
+    double elapsedTime(void) const;
     
     double getPosition(void);
     
@@ -122,6 +166,12 @@ private:
     void pushData(void);
     
     void popData(void);
+
+    double segmentAcceleration(void);
+
+    uint32_t findSegment(double t, uint32_t from) const;
+
+    void evaluateSegment(uint32_t index, double t, State &state) const;
 };
 
 void print_all(ProfilePlanner::Segment* segments, int num = 5);
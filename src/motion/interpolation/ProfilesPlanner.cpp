@@ -36,6 +36,7 @@ class ProfilesPlanner::ProfilesPlannerImpl
     double mStartPos = 0;
     double mStartVel = 0;
     double mStartAcc = 0; // reserved
+    PlanCache *mCache = nullptr;
 };
 
 ProfilesPlanner::ProfilesPlanner()
@@ -50,7 +51,24 @@ ProfilesPlanner::~ProfilesPlanner()
 
 bool ProfilesPlanner::plan(ProfileNode *node, double startPos, double startVel, double startAcc)
 {
-    return ProfilePlanner::plan(startPos, node->mEndPos, startVel, node->mVel, node->mEndVel, node->mAcc, node->mDec);
+    if (node->mJerk > 0 && node->mFreePos)
+    { // S曲线的终点位置按实际起始状态重新计算，避免低速爬行
+        node->mEndPos =
+            startPos + calculateDist(startVel, node->mVel, node->mAcc, node->mDec, node->mJerk, startAcc);
+    }
+
+    return ProfilePlanner::plan(startPos, node->mEndPos, startVel, node->mVel, node->mEndVel, node->mAcc, node->mDec,
+                                startAcc, node->mJerk, mImpl_->mCache);
+}
+
+void ProfilesPlanner::setCache(PlanCache *cache)
+{
+    mImpl_->mCache = cache;
+}
+
+PlanCache *ProfilesPlanner::cache(void) const
+{
+    return mImpl_->mCache;
 }
 
 }; // namespace Uranus
@@ -25,12 +25,11 @@
 #ifndef _URANUS_PROFILESPLANNER_HPP_
 #define _URANUS_PROFILESPLANNER_HPP_
 
-#include "ExeclQueue.h"
 #include "ProfilePlanner.h"
 
 namespace Uranus {
 
-class ProfileNode : virtual public ExeclNode
+class ProfileNode
 {
 public:
     double mStartPos = 0;
@@ -45,6 +44,8 @@ public:
     double mAcc = 0;
     double mDec = 0;
     double mJerk = 0;
+
+    bool mFreePos = false; //终点位置由速度规划决定（速度运动/停止）
     
     friend class ProfilesPlanner;
 };
@@ -60,6 +61,10 @@ public:
         double startPos, 
         double startVel, 
         double startAcc);
+
+    // 设定路径缓存，nullptr为不使用缓存
+    void setCache(PlanCache *cache);
+    PlanCache *cache(void) const;
     
 private:
     class ProfilesPlannerImpl;
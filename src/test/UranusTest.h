@@ -0,0 +1,70 @@
+/*
+ * UranusTest.h
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ * 单元测试的检查宏：失败时输出位置并计数，有失败时进程返回非0
+ *
+ */
+
+#ifndef _URANUS_TEST_HPP_
+#define _URANUS_TEST_HPP_
+
+#include <cmath>
+#include <cstdio>
+
+namespace Uranus
+{
+    namespace Test
+    {
+        inline int &failures(void)
+        {
+            static int count = 0;
+            return count;
+        }
+
+        inline void fail(const char *file, int line, const char *expr)
+        {
+            ++failures();
+            fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+        }
+
+        // 依次执行测试函数，返回进程退出码
+        inline int run(const char *name, void (*const *tests)(void), int num)
+        {
+            for (int i = 0; i < num; ++i)
+                tests[i]();
+
+            printf("%s: %d checks failed\n", name, failures());
+            return failures() ? 1 : 0;
+        }
+    }
+}
+
+#define URANUS_CHECK(expr)                                 \
+    do                                                     \
+    {                                                      \
+        if (!(expr))                                       \
+            Uranus::Test::fail(__FILE__, __LINE__, #expr); \
+    } while (0)
+
+#define URANUS_CHECK_NEAR(a, b, tol) URANUS_CHECK(std::fabs((double)(a) - (double)(b)) <= (tol))
+
+#endif /** _URANUS_TEST_HPP_ **/
@@ -0,0 +1,489 @@
+/*
+ * axis_move_test.cpp
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ * 轴运动队列测试：缓冲运动的速度前瞻与混合模式在各衔接点不停止、
+ * 不超过加减速度，且链末端准确到位；运动中连续更新的目标同样准确到位
+ *
+ */
+
+#include "Axis.h"
+#include "FbSingleAxis.h"
+#include "Scheduler.h"
+#include "UranusTest.h"
+#include <cmath>
+#include <vector>
+
+using namespace Uranus;
+
+static const double kFrequency = 1000;
+// 运动在多少个周期内必须完成
+static const int32_t kMaxCycles = 100000;
+
+struct Sample
+{
+    double mPos;
+    double mVel;
+    MC_AxisStatus mStatus;
+};
+
+// 单轴测试环境，构造完成时轴已使能
+struct AxisRig
+{
+    Scheduler mSched;
+    Axis *mAxis;
+    FbPower mPower;
+    std::vector<Sample> mSamples;
+
+    AxisRig()
+    {
+        mSched.setFrequency(kFrequency);
+        mAxis = mSched.newAxis(1, new Servo());
+        mPower.mAxis = mAxis;
+        mPower.mEnable = mPower.mEnablePositive = mPower.mEnableNegative = true;
+
+        for (int i = 0; i < 10 && !(mPower.mStatus && mPower.mValid); ++i)
+            cycle();
+        URANUS_CHECK(mPower.mStatus && mPower.mValid);
+        mSamples.clear();
+    }
+
+    ~AxisRig()
+    {
+        mSched.release();
+    }
+
+    void cycle(void)
+    {
+        mPower.call();
+        mSched.runCycle();
+        mSamples.push_back({mAxis->cmdPosition(), mAxis->cmdVelocity(), mAxis->status()});
+    }
+
+    // 执行到队列空闲
+    void runToIdle(void)
+    {
+        for (int32_t i = 0; i < kMaxCycles && mAxis->busy(); ++i)
+            cycle();
+        URANUS_CHECK(!mAxis->busy());
+    }
+
+    // 相邻采样的速度变化不超过acc
+    bool accWithin(double acc) const
+    {
+        double prev = 0;
+        for (const Sample &sample : mSamples)
+        {
+            if (std::fabs(sample.mVel - prev) > acc / kFrequency * (1 + 1e-9))
+                return false;
+            prev = sample.mVel;
+        }
+        return true;
+    }
+
+    // 相邻采样的位移与平均速度一致，衔接点不丢失行程
+    bool travelMatchesVel(double acc) const
+    {
+        for (size_t i = 1; i < mSamples.size(); ++i)
+        {
+            double travel = (mSamples[i].mPos - mSamples[i - 1].mPos) * kFrequency;
+            if (std::fabs(travel - (mSamples[i].mVel + mSamples[i - 1].mVel) / 2) > acc / kFrequency)
+                return false;
+        }
+        return true;
+    }
+
+    // 位置在(from, to)区间内的采样中最小的速度绝对值
+    double minVelBetween(double from, double to) const
+    {
+        double minVel = INFINITY;
+        for (const Sample &sample : mSamples)
+        {
+            if (sample.mPos > from && sample.mPos < to)
+                minVel = std::fmin(minVel, std::fabs(sample.mVel));
+        }
+        return minVel;
+    }
+
+    // 第一个到达pos的采样的速度
+    double velAt(double pos) const
+    {
+        for (const Sample &sample : mSamples)
+        {
+            if (sample.mPos >= pos)
+                return sample.mVel;
+        }
+        return NAN;
+    }
+
+    // 最后一个采样之前轴状态是否出现过静止
+    bool standstillBeforeEnd(void) const
+    {
+        for (size_t i = 0; i + 1 < mSamples.size(); ++i)
+        {
+            if (mSamples[i].mStatus == MC_AxisStatus::STANDSTILL)
+                return true;
+        }
+        return false;
+    }
+
+    double maxPos(void) const
+    {
+        double maxPos = -INFINITY;
+        for (const Sample &sample : mSamples)
+            maxPos = std::fmax(maxPos, sample.mPos);
+        return maxPos;
+    }
+};
+
+static void checkChainEnd(const AxisRig &rig, double endPos)
+{
+    URANUS_CHECK(!rig.mSamples.empty());
+    if (rig.mSamples.empty())
+        return;
+
+    URANUS_CHECK_NEAR(rig.mSamples.back().mPos, endPos, 1e-9);
+    URANUS_CHECK(rig.mSamples.back().mVel == 0.0);
+}
+
+static void addChain(Axis *axis, const double *targets, int num, double vel, double acc, double jerk)
+{
+    for (int i = 0; i < num; ++i)
+    {
+        MC_ErrorCode err = axis->addMovePos(nullptr, targets[i], vel, acc, acc, jerk, MC_ShiftingMode::ABSOLUTE,
+                                            MC_Direction::CURRENT, MC_BufferMode::BUFFERED);
+        URANUS_CHECK(MC_ErrorCode::GOOD == err);
+    }
+}
+
+static void testLookAheadNoStop(void)
+{
+    // 同向的缓冲运动以最大速度衔接，jerk为0与S曲线各一次
+    for (double jerk : {0.0, 20000.0})
+    {
+        AxisRig rig;
+        rig.mSched.setAxisLookAhead(rig.mAxis, true);
+        const double targets[] = {10, 20, 30};
+        addChain(rig.mAxis, targets, 3, 50, 500, jerk);
+        rig.runToIdle();
+
+        checkChainEnd(rig, 30);
+        URANUS_CHECK(rig.accWithin(500));
+        URANUS_CHECK(rig.travelMatchesVel(500));
+        URANUS_CHECK(rig.maxPos() <= 30 + 1e-9);
+        URANUS_CHECK(rig.minVelBetween(5, 25) >= 50 * (1 - 1e-9));
+    }
+}
+
+static void testLookAheadDisabledStops(void)
+{
+    AxisRig rig;
+    const double targets[] = {10, 20};
+    addChain(rig.mAxis, targets, 2, 50, 500, 0);
+    rig.runToIdle();
+
+    checkChainEnd(rig, 20);
+    URANUS_CHECK(rig.velAt(10) == 0.0);
+    URANUS_CHECK(rig.standstillBeforeEnd());
+}
+
+static void testLookAheadShortSegment(void)
+{
+    // 末段行程不足以从vel减速，衔接速度受距离与余量限制
+    AxisRig rig;
+    rig.mSched.setAxisLookAhead(rig.mAxis, true);
+    const double targets[] = {10, 10.5};
+    addChain(rig.mAxis, targets, 2, 50, 500, 0);
+    rig.runToIdle();
+
+    checkChainEnd(rig, 10.5);
+    URANUS_CHECK(rig.accWithin(500));
+    URANUS_CHECK(rig.travelMatchesVel(500));
+    URANUS_CHECK(rig.maxPos() <= 10.5 + 1e-9);
+    double junction = rig.velAt(10);
+    URANUS_CHECK(junction > 0);
+    URANUS_CHECK(junction <= std::sqrt(2 * 500 * 0.5) + 500 / kFrequency);
+}
+
+static void testLookAheadReversal(void)
+{
+    // 反向的衔接点必须停止，且不越过折返点
+    AxisRig rig;
+    rig.mSched.setAxisLookAhead(rig.mAxis, true);
+    const double targets[] = {10, 5, 15};
+    addChain(rig.mAxis, targets, 3, 50, 500, 0);
+    rig.runToIdle();
+
+    checkChainEnd(rig, 15);
+    URANUS_CHECK(rig.accWithin(500));
+
+    bool reversed = false, turnStopped = false;
+    double turnPos = -INFINITY;
+    for (size_t i = 1; i < rig.mSamples.size(); ++i)
+    {
+        if (!reversed && rig.mSamples[i].mVel < 0)
+        {
+            reversed = true;
+            turnPos = rig.mSamples[i - 1].mPos;
+            turnStopped = rig.mSamples[i - 1].mVel == 0.0;
+        }
+    }
+    URANUS_CHECK(reversed);
+    URANUS_CHECK(turnStopped);
+    URANUS_CHECK_NEAR(turnPos, 10, 1e-9);
+}
+
+static void testLookAheadReplanExecuting(void)
+{
+    // 后续运动在第一段执行中才加入，正在执行的节点重新规划后不在衔接点停止
+    for (double jerk : {0.0, 20000.0})
+    {
+        AxisRig rig;
+        rig.mSched.setAxisLookAhead(rig.mAxis, true);
+        const double first[] = {10};
+        addChain(rig.mAxis, first, 1, 50, 500, jerk);
+        for (int i = 0; i < 50; ++i)
+            rig.cycle();
+
+        const double rest[] = {20, 30};
+        addChain(rig.mAxis, rest, 2, 50, 500, jerk);
+        rig.runToIdle();
+
+        checkChainEnd(rig, 30);
+        URANUS_CHECK(rig.accWithin(500));
+        URANUS_CHECK(rig.travelMatchesVel(500));
+        URANUS_CHECK(rig.maxPos() <= 30 + 1e-9);
+        if (jerk == 0.0)
+            URANUS_CHECK(rig.minVelBetween(5, 25) >= 50 * (1 - 1e-9));
+        else // 正在执行的S曲线节点不重新规划，其后的衔接点不停止
+            URANUS_CHECK(rig.minVelBetween(15, 25) >= 50 * (1 - 1e-9));
+    }
+}
+
+static void testBlendingCaps(void)
+{
+    // 未开启前瞻时混合模式同样生效，衔接速度由前后两段的最大速度决定
+    struct
+    {
+        double mPrevVel;
+        double mNextVel;
+        MC_BufferMode mMode;
+        double mJunction;
+    } cases[] = {
+        {50, 20, MC_BufferMode::BLENDING_LOW, 20},      {50, 20, MC_BufferMode::BLENDING_PREVIOUS, 50},
+        {50, 20, MC_BufferMode::BLENDING_NEXT, 20},     {50, 20, MC_BufferMode::BLENDING_HIGH, 50},
+        {20, 50, MC_BufferMode::BLENDING_LOW, 20},      {20, 50, MC_BufferMode::BLENDING_PREVIOUS, 20},
+        {20, 50, MC_BufferMode::BLENDING_NEXT, 50},     {20, 50, MC_BufferMode::BLENDING_HIGH, 50},
+    };
+
+    for (const auto &one : cases)
+    {
+        for (double jerk : {0.0, 20000.0})
+        {
+            AxisRig rig;
+            Axis *axis = rig.mAxis;
+            URANUS_CHECK(MC_ErrorCode::GOOD == axis->addMovePos(nullptr, 10, one.mPrevVel, 500, 500, jerk,
+                                                                MC_ShiftingMode::ABSOLUTE, MC_Direction::CURRENT,
+                                                                MC_BufferMode::BUFFERED));
+            URANUS_CHECK(MC_ErrorCode::GOOD == axis->addMovePos(nullptr, 20, one.mNextVel, 500, 500, jerk,
+                                                                MC_ShiftingMode::ABSOLUTE, MC_Direction::CURRENT,
+                                                                one.mMode));
+            rig.runToIdle();
+
+            checkChainEnd(rig, 20);
+            URANUS_CHECK(rig.accWithin(500));
+            URANUS_CHECK(rig.travelMatchesVel(500));
+            URANUS_CHECK(rig.maxPos() <= 20 + 1e-9);
+            URANUS_CHECK(!rig.standstillBeforeEnd());
+            URANUS_CHECK_NEAR(rig.velAt(10), one.mJunction, 500 / kFrequency);
+        }
+    }
+}
+
+static void testBlendingReversal(void)
+{
+    // 反向时混合模式不生效，在折返点停止
+    AxisRig rig;
+    Axis *axis = rig.mAxis;
+    URANUS_CHECK(MC_ErrorCode::GOOD == axis->addMovePos(nullptr, 10, 50, 500, 500, 0, MC_ShiftingMode::ABSOLUTE,
+                                                        MC_Direction::CURRENT, MC_BufferMode::BUFFERED));
+    URANUS_CHECK(MC_ErrorCode::GOOD == axis->addMovePos(nullptr, 5, 50, 500, 500, 0, MC_ShiftingMode::ABSOLUTE,
+                                                        MC_Direction::CURRENT, MC_BufferMode::BLENDING_HIGH));
+    rig.runToIdle();
+
+    checkChainEnd(rig, 5);
+    URANUS_CHECK(rig.accWithin(500));
+    URANUS_CHECK_NEAR(rig.maxPos(), 10, 1e-9);
+    URANUS_CHECK(rig.velAt(10) == 0.0);
+}
+
+// 每周期调用功能块，直到完成或出错
+template <typename FB> static void runFb(AxisRig &rig, FB &fb, int32_t cycles = kMaxCycles)
+{
+    for (int32_t i = 0; i < cycles && !fb.mDone && !fb.mError; ++i)
+    {
+        fb.call();
+        rig.cycle();
+    }
+}
+
+static void startMoveAbsolute(AxisRig &rig, FbMoveAbsolute &fb, double pos, double jerk)
+{
+    fb.mAxis = rig.mAxis;
+    fb.mPosition = pos;
+    fb.mVelocity = 50;
+    fb.mAcceleration = fb.mDeceleration = 500;
+    fb.mJerk = jerk;
+    fb.mContinuousUpdate = true;
+    fb.mExecute = true;
+}
+
+static void testUpdateTarget(void)
+{
+    // 运动中修改目标位置，包括来不及停止需要越过后返回的目标
+    struct
+    {
+        int32_t mCycle;
+        double mPos;
+        bool mOvershoot;
+    } cases[] = {{100, 12, false}, {100, 25, false}, {300, 13, true}};
+
+    for (const auto &one : cases)
+    {
+        for (double jerk : {0.0, 20000.0})
+        {
+            AxisRig rig;
+            FbMoveAbsolute fb;
+            startMoveAbsolute(rig, fb, 20, jerk);
+            runFb(rig, fb, one.mCycle);
+
+            fb.mPosition = one.mPos;
+            runFb(rig, fb);
+
+            URANUS_CHECK(fb.mDone && !fb.mError);
+            checkChainEnd(rig, one.mPos);
+            URANUS_CHECK(rig.accWithin(500));
+            URANUS_CHECK(rig.travelMatchesVel(500));
+            if (!one.mOvershoot)
+                URANUS_CHECK(rig.maxPos() <= one.mPos + 1e-9);
+        }
+    }
+}
+
+static void testUpdateMaxVelocity(void)
+{
+    // 运动中降低最大速度，减速后以新速度到达原目标
+    for (double jerk : {0.0, 20000.0})
+    {
+        AxisRig rig;
+        FbMoveAbsolute fb;
+        startMoveAbsolute(rig, fb, 30, jerk);
+        runFb(rig, fb, 150);
+
+        fb.mVelocity = 20;
+        runFb(rig, fb);
+
+        URANUS_CHECK(fb.mDone && !fb.mError);
+        checkChainEnd(rig, 30);
+        URANUS_CHECK(rig.accWithin(500));
+        URANUS_CHECK(rig.travelMatchesVel(500));
+
+        double maxVel = 0;
+        for (size_t i = 300; i < rig.mSamples.size(); ++i)
+            maxVel = std::fmax(maxVel, rig.mSamples[i].mVel);
+        URANUS_CHECK(maxVel <= 20 * (1 + 1e-9));
+    }
+}
+
+static void testUpdateVelocity(void)
+{
+    // 速度运动到达速度后修改速度，不反向且再次到达
+    for (double jerk : {0.0, 20000.0})
+    {
+        AxisRig rig;
+        FbMoveVelocity fb;
+        fb.mAxis = rig.mAxis;
+        fb.mVelocity = 50;
+        fb.mAcceleration = fb.mDeceleration = 500;
+        fb.mJerk = jerk;
+        fb.mContinuousUpdate = true;
+        fb.mExecute = true;
+        runFb(rig, fb);
+        URANUS_CHECK(fb.mInVelocity);
+
+        size_t from = rig.mSamples.size();
+        fb.mVelocity = 20;
+        fb.call();
+        URANUS_CHECK(!fb.mInVelocity);
+        rig.cycle();
+        runFb(rig, fb);
+
+        URANUS_CHECK(fb.mInVelocity && !fb.mError);
+        URANUS_CHECK(rig.accWithin(500));
+        URANUS_CHECK(rig.travelMatchesVel(500));
+        URANUS_CHECK_NEAR(rig.mSamples.back().mVel, 20, 1e-9);
+
+        double minVel = INFINITY;
+        for (size_t i = from; i < rig.mSamples.size(); ++i)
+            minVel = std::fmin(minVel, rig.mSamples[i].mVel);
+        URANUS_CHECK(minVel >= 20 - 1e-9);
+    }
+}
+
+static void testUpdateRejected(void)
+{
+    // 非法的更新使功能块报错且轴停止，二者状态一致
+    AxisRig rig;
+    FbMoveAbsolute fb;
+    startMoveAbsolute(rig, fb, 20, 0);
+    runFb(rig, fb, 100);
+
+    fb.mVelocity = -1;
+    fb.call();
+    rig.cycle();
+
+    URANUS_CHECK(fb.mError && !fb.mBusy);
+    URANUS_CHECK(MC_ErrorCode::VEL_ILLEGAL == fb.mErrorID);
+    URANUS_CHECK(MC_AxisStatus::ERRORSTOP == rig.mAxis->status());
+
+    rig.runToIdle();
+    URANUS_CHECK(rig.mSamples.back().mVel == 0.0);
+    URANUS_CHECK(rig.mSamples.back().mPos < 20);
+}
+
+int main(void)
+{
+    static void (*const tests[])(void) = {
+        testLookAheadNoStop,
+        testLookAheadDisabledStops,
+        testLookAheadShortSegment,
+        testLookAheadReversal,
+        testLookAheadReplanExecuting,
+        testBlendingCaps,
+        testBlendingReversal,
+        testUpdateTarget,
+        testUpdateMaxVelocity,
+        testUpdateVelocity,
+        testUpdateRejected,
+    };
+
+    return Test::run("axis_move_test", tests, sizeof(tests) / sizeof(tests[0]));
+}
@@ -0,0 +1,276 @@
+/*
+ * profile_planner_test.cpp
+ *
+ * Copyright 2020 (C) SYMG(Shanghai) Intelligence System Co.,Ltd
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ *
+ * ProfilePlanner的S曲线规划测试：非零起始速度与加速度、短行程、反向，
+ * 以及jerk为0时与梯形规划逐位相同
+ *
+ */
+
+#include "PlanCache.h"
+#include "ProfilePlanner.h"
+#include "UranusTest.h"
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace Uranus;
+
+static const uint32_t kFrequency = 1000;
+// 规划在多少个tick内必须完成
+static const int32_t kMaxTicks = 1000000;
+
+struct Sample
+{
+    double mPos;
+    double mVel;
+    double mAcc;
+};
+
+// 执行到规划完成，返回全部采样
+static std::vector<Sample> runPlanner(ProfilePlanner &planner)
+{
+    std::vector<Sample> samples;
+    bool done = false;
+    while (!done && samples.size() < (size_t)kMaxTicks)
+    {
+        done = planner.execute();
+        samples.push_back({planner.data.position, planner.data.velocity, planner.data.acceleration});
+    }
+
+    URANUS_CHECK(done);
+    return samples;
+}
+
+/*
+ * 检查S曲线在各采样点的约束：终点到位且停止，速度不超过max(起始速度, vel)，
+ * 加速度不超过max(起始加速度, acc, dec)，相邻采样的加速度变化不超过jerk/frequency
+ */
+static void checkScurve(double startPos, double endPos, double startVel, double vel, double acc, double dec,
+                        double startAcc, double jerk)
+{
+    ProfilePlanner planner;
+    planner.setFrequency(kFrequency);
+    URANUS_CHECK(planner.plan(startPos, endPos, startVel, vel, 0, acc, dec, startAcc, jerk));
+
+    std::vector<Sample> samples = runPlanner(planner);
+    if (samples.empty())
+        return;
+
+    double tol = 1e-9;
+    double velLimit = std::fmax(std::fabs(startVel), vel) * (1 + tol);
+    double accLimit = std::fmax(std::fabs(startAcc), std::fmax(acc, dec)) * (1 + tol);
+    double jerkStep = jerk / kFrequency * (1 + tol);
+
+    double prevAcc = startAcc;
+    double prevPos = startPos;
+    bool velOk = true, accOk = true, jerkOk = true, posOk = true;
+    for (const Sample &sample : samples)
+    {
+        velOk &= std::fabs(sample.mVel) <= velLimit;
+        accOk &= std::fabs(sample.mAcc) <= accLimit;
+        jerkOk &= std::fabs(sample.mAcc - prevAcc) <= jerkStep;
+        posOk &= std::fabs(sample.mPos - prevPos) <= velLimit / kFrequency;
+        prevAcc = sample.mAcc;
+        prevPos = sample.mPos;
+    }
+
+    URANUS_CHECK(velOk);
+    URANUS_CHECK(accOk);
+    URANUS_CHECK(jerkOk);
+    URANUS_CHECK(posOk);
+
+    const Sample &last = samples.back();
+    URANUS_CHECK_NEAR(last.mPos, endPos, 1e-9);
+    URANUS_CHECK(last.mVel == 0.0);
+    URANUS_CHECK(last.mAcc == 0.0);
+    URANUS_CHECK(planner.getAcceleration() == 0.0);
+}
+
+static void testScurveFromRest(void)
+{
+    checkScurve(0, 100, 0, 100, 1000, 800, 0, 20000);
+    checkScurve(5, 20, 0, 60, 500, 700, 0, 5000);
+    checkScurve(0, -30, 0, 40, 600, 600, 0, 8000);
+}
+
+static void testScurveStartState(void)
+{
+    // 起始速度与加速度同向、反向，以及起始速度高于vel
+    checkScurve(0, 50, 20, 40, 1000, 800, 300, 20000);
+    checkScurve(0, 50, 20, 40, 1000, 800, -300, 20000);
+    checkScurve(0, 50, 60, 40, 1000, 800, 0, 20000);
+    checkScurve(0, 10, -20, 50, 1000, 800, 500, 20000);
+}
+
+static void testScurveShortMove(void)
+{
+    // 行程不足以达到vel或acc
+    checkScurve(0, 0.5, 0, 100, 1000, 800, 0, 20000);
+    checkScurve(0, 1e-3, 0, 100, 1000, 800, 0, 20000);
+    checkScurve(0, 2, 50, 40, 1000, 800, 0, 20000);
+}
+
+static void testScurveReversal(void)
+{
+    // 起始速度背离目标，先减速到0再反向
+    checkScurve(0, -10, 30, 50, 1000, 800, 0, 20000);
+    checkScurve(0, -10, 30, 50, 1000, 800, -400, 20000);
+    checkScurve(0, 10, -30, 50, 1000, 800, 400, 20000);
+}
+
+static void testScurveEndVelocity(void)
+{
+    ProfilePlanner planner;
+    planner.setFrequency(kFrequency);
+    URANUS_CHECK(planner.plan(0, 50, 0, 40, 20, 1000, 800, 0, 20000));
+
+    std::vector<Sample> samples = runPlanner(planner);
+    if (samples.empty())
+        return;
+
+    // 最后一个采样在终点前不到一个tick处
+    const Sample &last = samples.back();
+    URANUS_CHECK(last.mPos <= 50);
+    URANUS_CHECK(last.mPos >= 50 - 20.0 / kFrequency - 1e-9);
+    URANUS_CHECK_NEAR(last.mVel, 20, 20000.0 / kFrequency / kFrequency);
+}
+
+static void testScurveVelocityChange(void)
+{
+    // 速度运动的终点由起始状态推算，位移与变速所需距离只差舍入误差，不能反向
+    const double vels[][2] = {{50, 20}, {20, 50}, {30, 0.5}};
+    bool velOk = true, endOk = true;
+    for (const auto &one : vels)
+    {
+        double startVel = one[0], vel = one[1];
+        for (int32_t i = 0; i < 100; ++i)
+        {
+            double startPos = i * 0.37 - 10;
+            double endPos = startPos + ProfilePlanner::calculateDist(startVel, vel, 500, 500, 20000, 0);
+
+            ProfilePlanner planner;
+            planner.setFrequency(kFrequency);
+            URANUS_CHECK(planner.plan(startPos, endPos, startVel, vel, vel, 500, 500, 0, 20000));
+
+            std::vector<Sample> samples = runPlanner(planner);
+            for (const Sample &sample : samples)
+                velOk &= sample.mVel >= std::fmin(startVel, vel) - 1e-9;
+            endOk &= !samples.empty() && std::fabs(samples.back().mVel - vel) <= 20000.0 / kFrequency / kFrequency;
+        }
+    }
+
+    URANUS_CHECK(velOk);
+    URANUS_CHECK(endOk);
+}
+
+static void testPlanCacheBitIdentical(void)
+{
+    // 同一缓存先未命中后命中，行程不足以达到终速度时修正后的终速度同样复现
+    const double cases[][9] = {
+        // startPos, endPos, startVel, vel, endVel, acc, dec, startAcc, jerk
+        {0, 1, 0, 200, 100, 10, 10, 0, 0},
+        {0, 1, 0, 200, 100, 10, 10, 0, 50},
+        {3.5, 40, 12, 100, 20, 1000, 800, 0, 0},
+        {3.5, 40, 12, 100, 20, 1000, 800, 250, 20000},
+        {-2, 10, 30, 50, 0, 500, 500, 0, 0},
+    };
+
+    for (const auto &one : cases)
+    {
+        PlanCache cache;
+        cache.setSize(16);
+
+        ProfilePlanner miss, hit;
+        miss.setFrequency(kFrequency);
+        hit.setFrequency(kFrequency);
+        bool missRet = miss.plan(one[0], one[1], one[2], one[3], one[4], one[5], one[6], one[7], one[8], &cache);
+        bool hitRet = hit.plan(one[0], one[1], one[2], one[3], one[4], one[5], one[6], one[7], one[8], &cache);
+
+        PlanCacheStatistics stat;
+        cache.readStatistics(stat);
+        URANUS_CHECK(stat.mMisses == 1 && stat.mHits == 1);
+        URANUS_CHECK(missRet == hitRet);
+        URANUS_CHECK(miss.getEndVelocity() == hit.getEndVelocity());
+        URANUS_CHECK(miss.getEndPosition() == hit.getEndPosition());
+
+        std::vector<Sample> missSamples = runPlanner(miss);
+        std::vector<Sample> hitSamples = runPlanner(hit);
+        URANUS_CHECK(missSamples.size() == hitSamples.size());
+        URANUS_CHECK(missSamples.size() == hitSamples.size() &&
+                     !memcmp(missSamples.data(), hitSamples.data(), missSamples.size() * sizeof(Sample)));
+        URANUS_CHECK(miss.getEndVelocity() == hit.getEndVelocity());
+    }
+}
+
+static void testTrapezoidBitIdentical(void)
+{
+    // jerk为0时忽略起始加速度，采样按梯形规划的原有计算顺序逐位复现
+    ProfilePlanner planner, ignoreAcc;
+    planner.setFrequency(kFrequency);
+    ignoreAcc.setFrequency(kFrequency);
+    URANUS_CHECK(planner.plan(0, 37.5, 12, 100, 0, 1000, 800));
+    URANUS_CHECK(ignoreAcc.plan(0, 37.5, 12, 100, 0, 1000, 800, 250, 0));
+    URANUS_CHECK(!memcmp(planner.data.segments, ignoreAcc.data.segments, sizeof(planner.data.segments)));
+
+    bool same = true, formula = true;
+    bool done = false;
+    while (!done)
+    {
+        uint32_t index = planner.data.current_segment;
+        int32_t tick = planner.data.current_tick;
+        const ProfilePlanner::Segment &segment = planner.data.segments[index];
+
+        done = planner.execute();
+        ignoreAcc.execute();
+        same &= planner.data.position == ignoreAcc.data.position && planner.data.velocity == ignoreAcc.data.velocity;
+
+        if (tick > segment.tick)
+            continue; // 段末尾取段终点
+
+        double t = (double)tick / kFrequency;
+        double acc_2 = segment.acc * t / 2;
+        double vel = segment.start_vel + acc_2;
+        double pos = segment.start_position + vel * t;
+        vel += acc_2;
+        formula &= planner.data.position == pos && planner.data.velocity == vel;
+    }
+
+    URANUS_CHECK(same);
+    URANUS_CHECK(formula);
+    URANUS_CHECK(planner.getPosition() == 37.5);
+}
+
+int main(void)
+{
+    static void (*const tests[])(void) = {
+        testScurveFromRest,
+        testScurveStartState,
+        testScurveShortMove,
+        testScurveReversal,
+        testScurveEndVelocity,
+        testScurveVelocityChange,
+        testPlanCacheBitIdentical,
+        testTrapezoidBitIdentical,
+    };
+
+    return Test::run("profile_planner_test", tests, sizeof(tests) / sizeof(tests[0]));
+}